@@ -0,0 +1,33 @@
+#include "alloc_counter.hh"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+  std::atomic<size_t> g_allocations(0);
+}
+
+size_t kyaml::bench::allocations()
+{
+  return g_allocations.load(std::memory_order_relaxed);
+}
+
+// the replaceable global allocation functions, the array and nothrow forms end up here as well
+void *operator new(size_t size)
+{
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if(void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+  std::free(p);
+}
@@ -0,0 +1,36 @@
+#ifndef ALLOC_COUNTER_HH
+#define ALLOC_COUNTER_HH
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+
+namespace kyaml
+{
+  namespace bench
+  {
+    // number of calls to operator new so far, in this process
+    size_t allocations();
+
+    // reports the allocations per iteration of the benchmark loop it outlives as "allocs/op"
+    class alloc_counter
+    {
+    public:
+      alloc_counter(benchmark::State &state) :
+        d_state(state),
+        d_start(allocations())
+      {}
+
+      ~alloc_counter()
+      {
+        d_state.counters["allocs/op"] =
+          benchmark::Counter(static_cast<double>(allocations() - d_start), benchmark::Counter::kAvgIterations);
+      }
+
+    private:
+      benchmark::State &d_state;
+      size_t d_start;
+    };
+  }
+}
+
+#endif // ALLOC_COUNTER_HH
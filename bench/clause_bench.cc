@@ -0,0 +1,215 @@
+#include "alloc_counter.hh"
+#include "char_stream.hh"
+#include "clauses.hh"
+#include "context.hh"
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace kyaml;
+using namespace kyaml::clauses;
+
+namespace
+{
+  // takes every event, unlike null_builder it does not ask the clauses to skip building scalars
+  class counting_builder final : public document_builder
+  {
+  public:
+    size_t events = 0;
+
+    void start_sequence(context const &ctx) override
+    {
+      ++events;
+    }
+
+    void end_sequence(context const &ctx) override
+    {
+      ++events;
+    }
+
+    void start_mapping(context const &ctx) override
+    {
+      ++events;
+    }
+
+    void end_mapping(context const &ctx) override
+    {
+      ++events;
+    }
+
+    void add_anchor(context const &ctx, string const &anchor) override
+    {
+      ++events;
+    }
+
+    void add_alias(context const &ctx, string const &alias) override
+    {
+      ++events;
+    }
+
+    void add_scalar(context const &ctx, string const &val) override
+    {
+      ++events;
+      benchmark::DoNotOptimize(val.data());
+    }
+
+    void add_borrowed_scalar(context const &ctx, string_view val) override
+    {
+      ++events;
+      benchmark::DoNotOptimize(val.data());
+    }
+
+    void add_plain_scalar(context const &ctx, string_view val, bool borrowed) override
+    {
+      ++events;
+      benchmark::DoNotOptimize(val.data());
+    }
+
+    void add_atom(context const &ctx, char32_t c) override
+    {}
+
+    void add_text(context const &ctx, string_view text) override
+    {}
+
+    void add_property(context const &ctx, string const &prop) override
+    {
+      ++events;
+    }
+  };
+
+  // run one clause over input in the given context, from the start each iteration
+  template <typename clause_t>
+  void parse_clause(benchmark::State &state,
+                    string const &input,
+                    int indent_level,
+                    kyaml::context::blockflow_t bf)
+  {
+    {
+      bench::alloc_counter allocs(state);
+      for(auto _ : state)
+      {
+        char_stream stream(input);
+        kyaml::context ctx(stream, indent_level, bf);
+        counting_builder builder;
+
+        clause_t c(ctx);
+        if(!c.parse(builder))
+        {
+          state.SkipWithError("clause did not match");
+          break;
+        }
+        benchmark::DoNotOptimize(builder.events);
+      }
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+  }
+
+  string repeat(string const &s, size_t n)
+  {
+    string result;
+    for(size_t i = 0; i < n; ++i)
+      result += s;
+    return result;
+  }
+
+  string block_input(char indicator, size_t lines)
+  {
+    return string(1, indicator) + "\n" + repeat("  some block text on a line of its own\n", lines);
+  }
+
+  string flow_sequence_input(size_t n)
+  {
+    string result = "[";
+    for(size_t i = 0; i < n; ++i)
+      result += (i ? ", item" : "item") + to_string(i);
+    return result + "]";
+  }
+
+  string flow_mapping_input(size_t n)
+  {
+    string result = "{";
+    for(size_t i = 0; i < n; ++i)
+      result += (i ? ", key" : "key") + to_string(i) + ": value" + to_string(i);
+    return result + "}";
+  }
+}
+
+static void char_stream_buffer(benchmark::State &state)
+{
+  string input = repeat("key: value with some text\n", state.range(0));
+  {
+    bench::alloc_counter allocs(state);
+    for(auto _ : state)
+    {
+      char_stream stream(input);
+      char_t c;
+      while(stream.get(c))
+        benchmark::DoNotOptimize(c);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(char_stream_buffer)->Arg(1000);
+
+static void char_stream_istream(benchmark::State &state)
+{
+  string input = repeat("key: value with some text\n", state.range(0));
+  {
+    bench::alloc_counter allocs(state);
+    for(auto _ : state)
+    {
+      istringstream str(input);
+      char_stream stream(str);
+      char_t c;
+      while(stream.get(c))
+        benchmark::DoNotOptimize(c);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(char_stream_istream)->Arg(1000);
+
+static void clause_plain(benchmark::State &state)
+{
+  parse_clause<plain>(state, repeat("plain words ", state.range(0)) + "end", 0, kyaml::context::FLOW_OUT);
+}
+BENCHMARK(clause_plain)->Arg(100);
+
+static void clause_double_quoted(benchmark::State &state)
+{
+  string input = "\"" + repeat("quoted \\t text \\u00e9 ", state.range(0)) + "\"";
+  parse_clause<double_quoted>(state, input, 0, kyaml::context::FLOW_IN);
+}
+BENCHMARK(clause_double_quoted)->Arg(100);
+
+static void clause_single_quoted(benchmark::State &state)
+{
+  string input = "'" + repeat("it''s quoted text ", state.range(0)) + "'";
+  parse_clause<single_quoted>(state, input, 0, kyaml::context::FLOW_IN);
+}
+BENCHMARK(clause_single_quoted)->Arg(100);
+
+static void clause_literal(benchmark::State &state)
+{
+  parse_clause<line_literal>(state, block_input('|', state.range(0)), -1, kyaml::context::NA);
+}
+BENCHMARK(clause_literal)->Arg(100);
+
+static void clause_folded(benchmark::State &state)
+{
+  parse_clause<content_folded>(state, block_input('>', state.range(0)), -1, kyaml::context::NA);
+}
+BENCHMARK(clause_folded)->Arg(100);
+
+static void clause_flow_sequence(benchmark::State &state)
+{
+  parse_clause<flow_sequence>(state, flow_sequence_input(state.range(0)), 0, kyaml::context::FLOW_IN);
+}
+BENCHMARK(clause_flow_sequence)->Arg(100);
+
+static void clause_flow_mapping(benchmark::State &state)
+{
+  parse_clause<flow_mapping>(state, flow_mapping_input(state.range(0)), 0, kyaml::context::FLOW_IN);
+}
+BENCHMARK(clause_flow_mapping)->Arg(100);
@@ -0,0 +1,87 @@
+#include "corpus.hh"
+
+using namespace std;
+
+namespace
+{
+  // one service, at the given indentation
+  string service(size_t i, string const &indent)
+  {
+    string n = to_string(i);
+    return
+      indent + "name: service-" + n + "\n" +
+      indent + "labels: &labels" + n + "\n" +
+      indent + "  app: frontend\n" +
+      indent + "  tier: \"web\"\n" +
+      indent + "  owner: 'team " + n + "'\n" +
+      indent + "replicas: " + to_string(i % 7 + 1) + "\n" +
+      indent + "weight: " + to_string(i % 10) + ".25\n" +
+      indent + "enabled: true\n" +
+      indent + "selector: *labels" + n + "\n" +
+      indent + "ports: [80, 443, 8080]\n" +
+      indent + "resources: {cpu: 500m, memory: 128Mi}\n" +
+      indent + "containers:\n" +
+      indent + "  - name: nginx\n" +
+      indent + "    image: nginx-1.25\n" +
+      indent + "    args: [\"--port\", \"8080\", \"--verbose\"]\n" +
+      indent + "    env:\n" +
+      indent + "      - {name: MODE, value: production}\n" +
+      indent + "      - {name: TIMEOUT, value: !!str 30}\n" +
+      indent + "  - name: sidecar\n" +
+      indent + "    image: envoy\n" +
+      indent + "config: |\n" +
+      indent + "  listen 8080;\n" +
+      indent + "  server_name example.com;\n" +
+      indent + "  root /var/www/html;\n" +
+      indent + "description: >\n" +
+      indent + "  A folded description that goes\n" +
+      indent + "  on for a couple of lines.\n";
+  }
+}
+
+string const &kyaml::bench::small_document()
+{
+  static const string doc = service(0, "");
+  return doc;
+}
+
+string kyaml::bench::generated_document(size_t n)
+{
+  string result = "services:\n";
+  for(size_t i = 0; i < n; ++i)
+    result += "  service" + to_string(i) + ":\n" + service(i, "    ");
+  return result;
+}
+
+string kyaml::bench::document_stream(size_t n)
+{
+  string result;
+  for(size_t i = 0; i < n; ++i)
+    result += "---\n" + service(i, "");
+  return result;
+}
+
+string kyaml::bench::block_mapping(size_t n)
+{
+  string result;
+  for(size_t i = 0; i < n; ++i)
+    result += "key" + to_string(i) + ": value " + to_string(i) + "\n";
+  return result;
+}
+
+string kyaml::bench::flow_sequence(size_t n)
+{
+  string result = "[";
+  for(size_t i = 0; i < n; ++i)
+    result += "\"item " + to_string(i) + "\", ";
+  result += "]";
+  return result;
+}
+
+string kyaml::bench::literal(size_t n)
+{
+  string result = "text: |\n";
+  for(size_t i = 0; i < n; ++i)
+    result += "  some literal text on line " + to_string(i) + "\n";
+  return result;
+}
@@ -0,0 +1,27 @@
+#ifndef CORPUS_HH
+#define CORPUS_HH
+
+#include <string>
+
+namespace kyaml
+{
+  namespace bench
+  {
+    // a kubernetes-style manifest, about 1KB. Mixes block and flow collections, plain, quoted and
+    // literal scalars, numbers, tags, anchors and aliases.
+    std::string const &small_document();
+
+    // n services, each like small_document(), under one mapping
+    std::string generated_document(size_t n);
+
+    // n copies of small_document() as separate documents
+    std::string document_stream(size_t n);
+
+    // documents that stress a single construct
+    std::string block_mapping(size_t n);
+    std::string flow_sequence(size_t n);
+    std::string literal(size_t n);
+  }
+}
+
+#endif // CORPUS_HH
@@ -0,0 +1,88 @@
+#include "alloc_counter.hh"
+#include "corpus.hh"
+#include "kyaml.hh"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+  const size_t services = 100;
+
+  unique_ptr<const kyaml::document> parse(string const &input, bool resolve)
+  {
+    kyaml::parser::options opts;
+    opts.resolve = resolve;
+    kyaml::parser p(input, opts);
+    return p.parse();
+  }
+
+  vector<string> service_keys()
+  {
+    vector<string> result;
+    for(size_t i = 0; i < services; ++i)
+      result.push_back("service" + to_string(i));
+    return result;
+  }
+
+  // call f(doc, key) for each service, counting one item per call
+  template <typename func_t>
+  void access(benchmark::State &state, bool resolve, func_t f)
+  {
+    string input = kyaml::bench::generated_document(services);
+    auto doc = parse(input, resolve);
+    vector<string> keys = service_keys();
+    {
+      kyaml::bench::alloc_counter allocs(state);
+      for(auto _ : state)
+        for(string const &key : keys)
+          f(*doc, key);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+  }
+}
+
+static void dom_value(benchmark::State &state)
+{
+  access(state, false, [](kyaml::document const &doc, string const &key)
+  {
+    benchmark::DoNotOptimize(&doc.value("services", key, "containers", 0, "image").get());
+  });
+}
+BENCHMARK(dom_value);
+
+static void dom_has(benchmark::State &state)
+{
+  access(state, false, [](kyaml::document const &doc, string const &key)
+  {
+    benchmark::DoNotOptimize(doc.has("services", key, "labels", "tier"));
+    benchmark::DoNotOptimize(doc.has("services", key, "missing"));
+  });
+}
+BENCHMARK(dom_has);
+
+static void dom_as(benchmark::State &state)
+{
+  access(state, false, [](kyaml::document const &doc, string const &key)
+  {
+    kyaml::node const &service = doc.value("services", key);
+    benchmark::DoNotOptimize(service.value("replicas").as_scalar().as<int>());
+    benchmark::DoNotOptimize(service.value("weight").as_scalar().as<double>());
+    benchmark::DoNotOptimize(service.value("enabled").as_scalar().as<bool>());
+  });
+}
+BENCHMARK(dom_as);
+
+static void dom_as_resolved(benchmark::State &state)
+{
+  access(state, true, [](kyaml::document const &doc, string const &key)
+  {
+    kyaml::node const &service = doc.value("services", key);
+    benchmark::DoNotOptimize(service.value("replicas").as_scalar().as<int>());
+    benchmark::DoNotOptimize(service.value("weight").as_scalar().as<double>());
+    benchmark::DoNotOptimize(service.value("enabled").as_scalar().as<bool>());
+  });
+}
+BENCHMARK(dom_as_resolved);
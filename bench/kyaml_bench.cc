@@ -0,0 +1,133 @@
+#include "alloc_counter.hh"
+#include "corpus.hh"
+#include "kyaml.hh"
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+
+using namespace std;
+using namespace kyaml::bench;
+
+namespace
+{
+  void parse(benchmark::State &state, string const &input, kyaml::parser::options const &opts = kyaml::parser::options())
+  {
+    {
+      alloc_counter allocs(state);
+      for(auto _ : state)
+      {
+        kyaml::parser p(input, opts);
+        benchmark::DoNotOptimize(p.parse());
+      }
+    }
+    state.SetBytesProcessed(state.iterations() * input.size());
+  }
+}
+
+static void block_mapping(benchmark::State &state)
+{
+  parse(state, block_mapping(state.range(0)));
+}
+BENCHMARK(block_mapping)->Arg(1000);
+
+static void flow_sequence(benchmark::State &state)
+{
+  parse(state, flow_sequence(state.range(0)));
+}
+BENCHMARK(flow_sequence)->Arg(1000);
+
+static void literal(benchmark::State &state)
+{
+  parse(state, literal(state.range(0)));
+}
+BENCHMARK(literal)->Arg(1000);
+
+static void parse_small(benchmark::State &state)
+{
+  parse(state, small_document());
+}
+BENCHMARK(parse_small);
+
+// about 40KB and 1MB
+static void parse_generated(benchmark::State &state)
+{
+  parse(state, generated_document(state.range(0)));
+}
+BENCHMARK(parse_generated)->Arg(40)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+static void parse_resolved(benchmark::State &state)
+{
+  kyaml::parser::options opts;
+  opts.resolve = true;
+  parse(state, generated_document(state.range(0)), opts);
+}
+BENCHMARK(parse_resolved)->Arg(40);
+
+static void parse_tape(benchmark::State &state)
+{
+  string input = generated_document(state.range(0));
+  {
+    alloc_counter allocs(state);
+    for(auto _ : state)
+    {
+      kyaml::parser p(input);
+      benchmark::DoNotOptimize(p.parse_tape());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(parse_tape)->Arg(40);
+
+static void validate(benchmark::State &state)
+{
+  string input = generated_document(state.range(0));
+  {
+    alloc_counter allocs(state);
+    for(auto _ : state)
+    {
+      kyaml::parser p(input);
+      if(!p.validate())
+      {
+        state.SkipWithError("invalid input");
+        break;
+      }
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(validate)->Arg(40);
+
+// all documents of a stream, from a buffer
+static void multi_document(benchmark::State &state)
+{
+  string input = document_stream(state.range(0));
+  {
+    alloc_counter allocs(state);
+    for(auto _ : state)
+    {
+      kyaml::parser p(input);
+      for(int64_t i = 0; i < state.range(0); ++i)
+        benchmark::DoNotOptimize(p.parse());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(multi_document)->Arg(40);
+
+// all documents of a stream, from a std::istream
+static void multi_document_istream(benchmark::State &state)
+{
+  string input = document_stream(state.range(0));
+  {
+    alloc_counter allocs(state);
+    for(auto _ : state)
+    {
+      istringstream str(input);
+      kyaml::parser p(str);
+      for(int64_t i = 0; i < state.range(0); ++i)
+        benchmark::DoNotOptimize(p.parse());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * input.size());
+}
+BENCHMARK(multi_document_istream)->Arg(40);
@@ -0,0 +1,321 @@
+#include "base64.hh"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define KYAML_BASE64_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace kyaml;
+
+namespace
+{
+  enum : uint8_t
+  {
+    PAD = 64,
+    SPACE = 65,
+    INVALID = 255,
+  };
+
+  // the value of each character
+  struct decode_table
+  {
+    uint8_t value[256];
+
+    constexpr decode_table() :
+      value()
+    {
+      for(int c = 0; c < 256; ++c)
+        value[c] = INVALID;
+      for(int c = 'A'; c <= 'Z'; ++c)
+        value[c] = c - 'A';
+      for(int c = 'a'; c <= 'z'; ++c)
+        value[c] = c - 'a' + 26;
+      for(int c = '0'; c <= '9'; ++c)
+        value[c] = c - '0' + 52;
+      value[int('+')] = 62;
+      value[int('/')] = 63;
+      value[int('=')] = PAD;
+      for(char c : {' ', '\t', '\n', '\r'})
+        value[int(c)] = SPACE;
+    }
+  };
+
+  constexpr decode_table s_table;
+
+  inline uint8_t lookup(char c)
+  {
+    return s_table.value[static_cast<uint8_t>(c)];
+  }
+
+#ifdef KYAML_BASE64_X86
+  // 32 characters into 24 bytes, false if any of them is not a base64 digit. Writes 32 bytes.
+  // After "Faster Base64 Encoding and Decoding Using AVX2 Instructions", Muła and Lemire.
+  __attribute__((target("avx2")))
+  bool decode_block_avx2(char const *source, uint8_t *target)
+  {
+    const __m256i lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a,
+                                            0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                            0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m256i lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                                            0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                            0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0,
+                                              0, 16, 19, 4, -65, -65, -71, -71,
+                                              0, 0, 0, 0, 0, 0, 0, 0);
+    const __m256i mask_2f = _mm256_set1_epi8(0x2f);
+
+    __m256i in = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(source));
+
+    // classify by nibbles: a character is valid if its low and high nibble classes don't overlap
+    __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(in, 4), mask_2f);
+    __m256i lo_nibbles = _mm256_and_si256(in, mask_2f);
+    __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+    __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+    if(!_mm256_testz_si256(lo, hi))
+      return false;
+
+    // the offset to the value only depends on the high nibble, except for '/'
+    __m256i eq_2f = _mm256_cmpeq_epi8(in, mask_2f);
+    __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+    __m256i values = _mm256_add_epi8(in, roll);
+
+    // pack 4 x 6 bits into 3 bytes per 32-bit word, then the 12 bytes of each lane together
+    __m256i merged = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+    __m256i words = _mm256_madd_epi16(merged, _mm256_set1_epi32(0x00011000));
+    __m256i bytes = _mm256_shuffle_epi8(words, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                                2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+    bytes = _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1));
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(target), bytes);
+    return true;
+  }
+
+  // as above, 16 characters into 12 bytes. Writes 16 bytes.
+  __attribute__((target("sse4.1")))
+  bool decode_block_sse4(char const *source, uint8_t *target)
+  {
+    const __m128i lut_lo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x11, 0x13, 0x1a, 0x1b, 0x1b, 0x1b, 0x1a);
+    const __m128i lut_hi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71,
+                                           0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i mask_2f = _mm_set1_epi8(0x2f);
+
+    __m128i in = _mm_loadu_si128(reinterpret_cast<__m128i const *>(source));
+
+    __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(in, 4), mask_2f);
+    __m128i lo_nibbles = _mm_and_si128(in, mask_2f);
+    __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+    __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+    if(!_mm_testz_si128(lo, hi))
+      return false;
+
+    __m128i eq_2f = _mm_cmpeq_epi8(in, mask_2f);
+    __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+    __m128i values = _mm_add_epi8(in, roll);
+
+    __m128i merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    __m128i words = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+    __m128i bytes = _mm_shuffle_epi8(words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(target), bytes);
+    return true;
+  }
+
+  typedef enum
+  {
+    SCALAR_ONLY,
+    SSE4,
+    AVX2,
+  } simd_t;
+
+  simd_t detect_simd()
+  {
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+      return AVX2;
+    if(__builtin_cpu_supports("sse4.1"))
+      return SSE4;
+    return SCALAR_ONLY;
+  }
+#endif
+
+  class decoder
+  {
+  public:
+    decoder(string_view source, uint8_t *target, size_t capacity) :
+      d_src(source.data()),
+      d_end(source.data() + source.size()),
+      d_out(target),
+      d_out_end(target + capacity)
+    {}
+
+    bool run()
+    {
+#ifdef KYAML_BASE64_X86
+      static const simd_t simd = detect_simd();
+      if(simd != SCALAR_ONLY)
+        return run_simd(simd);
+#endif
+      return scalar(d_end) && finish();
+    }
+
+    size_t written(uint8_t const *target) const
+    {
+      return d_out - target;
+    }
+
+  private:
+#ifdef KYAML_BASE64_X86
+    bool run_simd(simd_t simd)
+    {
+      while(d_src < d_end)
+      {
+        // blocks only start on whole quads and stop at anything but digits, whitespace for
+        // example. The scalar decoder then takes over for a stretch.
+        if(simd == AVX2 && d_end - d_src >= 32 && d_out_end - d_out >= 32 && decode_block_avx2(d_src, d_out))
+        {
+          d_src += 32;
+          d_out += 24;
+        }
+        else if(d_end - d_src >= 16 && d_out_end - d_out >= 16 && decode_block_sse4(d_src, d_out))
+        {
+          d_src += 16;
+          d_out += 12;
+        }
+        else
+        {
+          char const *until = d_end - d_src > 16 ? d_src + 16 : d_end;
+          if(!scalar(until))
+            return false;
+          if(d_done)
+            break;
+        }
+      }
+      return scalar(d_end) && finish();
+    }
+#endif
+
+    // decode up to until, and then on to the end of the current quad
+    bool scalar(char const *until)
+    {
+      while(d_src < d_end && (d_src < until || d_count))
+      {
+        // whole quads in one go
+        if(!d_count && !d_done && d_end - d_src >= 4 && d_out_end - d_out >= 3)
+        {
+          uint32_t a = lookup(d_src[0]);
+          uint32_t b = lookup(d_src[1]);
+          uint32_t c = lookup(d_src[2]);
+          uint32_t d = lookup(d_src[3]);
+          if((a | b | c | d) < 64)
+          {
+            uint32_t bits = (a << 18) | (b << 12) | (c << 6) | d;
+            d_out[0] = bits >> 16;
+            d_out[1] = bits >> 8;
+            d_out[2] = bits;
+            d_out += 3;
+            d_src += 4;
+            continue;
+          }
+        }
+
+        uint8_t v = lookup(*d_src++);
+        if(v == SPACE)
+          continue;
+        if(d_done || v == INVALID)
+          return false;
+        if(v == PAD)
+        {
+          if(!pad())
+            return false;
+          continue;
+        }
+
+        d_bits = (d_bits << 6) | v;
+        if(++d_count == 4)
+        {
+          if(d_out_end - d_out < 3)
+            return false;
+          d_out[0] = d_bits >> 16;
+          d_out[1] = d_bits >> 8;
+          d_out[2] = d_bits;
+          d_out += 3;
+          d_count = 0;
+          d_bits = 0;
+        }
+      }
+      return true;
+    }
+
+    // a '=' was read: the quad has to end in "x=", "xx=" or "xx==" and nothing may follow
+    bool pad()
+    {
+      if(d_count == 3)
+      {
+        if(d_out_end - d_out < 2)
+          return false;
+        d_out[0] = d_bits >> 10;
+        d_out[1] = d_bits >> 2;
+        d_out += 2;
+      }
+      else if(d_count == 2)
+      {
+        // the second '='
+        while(d_src < d_end && lookup(*d_src) == SPACE)
+          ++d_src;
+        if(d_src == d_end || lookup(*d_src) != PAD || d_out_end - d_out < 1)
+          return false;
+        ++d_src;
+        d_out[0] = d_bits >> 4;
+        d_out += 1;
+      }
+      else
+        return false;
+
+      d_count = 0;
+      d_bits = 0;
+      d_done = true;
+      return true;
+    }
+
+    bool finish() const
+    {
+      return d_count == 0;
+    }
+
+    char const *d_src;
+    char const *d_end;
+    uint8_t *d_out;
+    uint8_t *d_out_end;
+    uint32_t d_bits = 0;
+    unsigned d_count = 0; // digits in d_bits
+    bool d_done = false;  // seen the padding
+  };
+}
+
+bool kyaml::decode_base64(string_view source, uint8_t *target, size_t capacity, size_t &written)
+{
+  decoder dec(source, target, capacity);
+  if(!dec.run())
+    return false;
+
+  written = dec.written(target);
+  return true;
+}
+
+bool kyaml::decode_base64(string_view source, vector<uint8_t> &target)
+{
+  size_t start = target.size();
+  target.resize(start + base64_decoded_size(source.size()));
+
+  size_t written = 0;
+  bool result = decode_base64(source, target.data() + start, target.size() - start, written);
+  target.resize(start + (result ? written : 0));
+  return result;
+}
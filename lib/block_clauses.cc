@@ -1,6 +1,7 @@
 #include "block_clauses.hh"
 #include "document_builder.hh"
 #include <sstream>
+#include <type_traits>
 
 using namespace std;
 using namespace kyaml;
@@ -54,6 +55,87 @@ namespace
   private:
     int d_value;
   };
+
+  typedef void (document_builder::*collection_event)(document_builder::context const &);
+
+  // an entry of a block collection. Nothing but an entry starts with head_t, so once that is there
+  // the collection is committed to it: what eg held back is released and the rest of the entry is
+  // forwarded as it goes. Should the rest fail after all the document is invalid, no valid parse
+  // ever sees those events. held_t are the entries that have no such head, they are held back
+  // until they are complete.
+  template <typename head_t, typename rest_t, typename held_t = void>
+  struct entry
+  {
+    static bool parse(context &ctx, event_guard &eg, document_builder &builder)
+    {
+      if constexpr(!is_void_v<held_t>)
+      {
+        held_t held(ctx);
+        if(held.parse(eg.builder()))
+        {
+          eg.release();
+          return true;
+        }
+      }
+
+      stream_guard sg(ctx);
+
+      head_t head(ctx);
+      if(!head.parse(eg.builder()))
+        return false;
+      eg.release();
+
+      rest_t rest(ctx);
+      if(!rest.parse(builder))
+        return false;
+      sg.release();
+      return true;
+    }
+  };
+
+  typedef entry<internal::and_clause<indent_clause_eq, block_seq_indicator>,
+                block_seq_node> seq_entry;
+  typedef entry<block_seq_indicator,
+                block_seq_node> compact_seq_entry;
+  typedef entry<internal::and_clause<indent_clause_eq, block_map_implicit_head>,
+                block_map_implicit_node,
+                internal::and_clause<indent_clause_eq, block_map_explicit_entry> > map_entry;
+  typedef entry<block_map_implicit_head,
+                block_map_implicit_node,
+                block_map_explicit_entry> compact_map_entry;
+
+  template <typename entry_t>
+  bool parse_entry(context &ctx, document_builder &builder)
+  {
+    event_guard eg(builder);
+    return entry_t::parse(ctx, eg, builder);
+  }
+
+  // a block collection is a first entry followed by more entries. The start event is held back
+  // until the first entry commits the collection, from then on everything is forwarded as it goes.
+  template <typename first_t, typename next_t>
+  bool parse_entries(context &ctx, document_builder &builder, collection_event start, collection_event end)
+  {
+    stream_guard sg(ctx);
+    event_guard eg(builder);
+
+    (eg.builder().*start)(ctx);
+    if(!first_t::parse(ctx, eg, builder))
+      return false;
+    sg.release();
+
+    char_stream::mark_t before = ctx.stream().mark();
+    while(parse_entry<next_t>(ctx, builder))
+    {
+      char_stream::mark_t after = ctx.stream().mark();
+      if(after <= before)
+        break;
+      before = after;
+    }
+
+    (builder.*end)(ctx);
+    return true;
+  }
 }
 
 int kyaml::clauses::internal::delta_indent(context &ctx)
@@ -217,25 +299,7 @@ bool block_collection::parse(document_builder &builder)
 
 bool compact_mapping::parse(document_builder &builder)
 {
-  bool result = false;
-
-  typedef internal::and_clause<block_map_entry,
-                               internal::zero_or_more<internal::and_clause<indent_clause_eq,
-                                                                           block_map_entry>
-                                                      >
-                               > cm_clause;
-
-  cm_clause cm(ctx());
-  replay_builder rb;
-  if(cm.parse(rb))
-  {
-    result = true;
-    builder.start_mapping(ctx());
-    rb.replay(builder);
-    builder.end_mapping(ctx());
-  }
-
-  return result;
+  return parse_entries<compact_map_entry, map_entry>(ctx(), builder, &document_builder::start_mapping, &document_builder::end_mapping);
 }
 
 bool block_indented::parse(document_builder &builder)
@@ -296,18 +360,7 @@ bool block_sequence::parse(document_builder &builder)
   {
     ctx().set_indent(n + m);
 
-    replay_builder rb;
-    typedef internal::one_or_more<internal::and_clause<indent_clause_eq, block_seq_entry> > bs_clause;
-
-    bs_clause bs(ctx());
-    if(bs.parse(rb))
-    {
-      builder.start_sequence(ctx());
-      rb.replay(builder);
-      builder.end_sequence(ctx());
-
-      return true;
-    }
+    return parse_entries<seq_entry, seq_entry>(ctx(), builder, &document_builder::start_sequence, &document_builder::end_sequence);
   }
   return false;
 }
@@ -324,43 +377,16 @@ bool block_mapping::parse(document_builder &builder)
   {
     ctx().set_indent(n + m);
 
-    typedef internal::one_or_more<internal::and_clause<indent_clause_eq, block_map_entry> > bs_clause;
-    
-    bs_clause bs(ctx());
-    replay_builder rb;
-    if(bs.parse(rb))
-    {
-      builder.start_mapping(ctx());
-      rb.replay(builder);
-      builder.end_mapping(ctx());
-
-      return true;
-    } 
+    return parse_entries<map_entry, map_entry>(ctx(), builder, &document_builder::start_mapping, &document_builder::end_mapping);
   }
   return false;
 }
 
-
 bool compact_sequence::parse(document_builder &builder)
 {
-  bool result = false;
-  typedef internal::and_clause<block_seq_entry,
-                               internal::zero_or_more<internal::and_clause<indent_clause_eq,
-                                                                           block_seq_entry> > > cs_clause;
-
-  cs_clause d(ctx());
-  replay_builder rb;
-  if(d.parse(rb))
-  {
-    result = true;
-    builder.start_sequence(ctx());
-    rb.replay(builder);
-    builder.end_sequence(ctx());
-  }
-  return result;
+  return parse_entries<compact_seq_entry, seq_entry>(ctx(), builder, &document_builder::start_sequence, &document_builder::end_sequence);
 }
 
-
 bool literal_content::parse(document_builder &builder)
 {
   stream_guard sg(ctx());
@@ -466,3 +492,98 @@ bool content_folded::parse(document_builder &builder)
   }
   return false;
 }
+
+block_collection_entries::block_collection_entries(context &ctx) :
+  d_ctx(ctx),
+  d_indent(0),
+  d_entry(nullptr),
+  d_end(nullptr),
+  d_mark(0),
+  d_ended(false)
+{}
+
+bool block_collection_entries::start(document_builder &builder)
+{
+  typedef internal::all_of<internal::zero_or_one<internal::and_clause<internal::state_scope<internal::indent_inc_modifier, separate>,
+                                                                      internal::state_scope<internal::indent_inc_modifier, properties>
+                                                                      >
+                                                 >,
+                           sline_comment
+                           > head_t;
+
+  stream_guard sg(d_ctx);
+  event_guard eg(builder);
+
+  head_t head(d_ctx);
+  if(!head.parse(eg.builder()))
+    return false;
+
+  bool sequence;
+  {
+    state_guard stg(d_ctx);
+    seq_spaces ss(d_ctx);
+    sequence =
+      ss.parse(eg.builder()) &&
+      start<seq_entry>(eg.builder(), &document_builder::start_sequence, &document_builder::end_sequence);
+  }
+
+  if(sequence || start<map_entry>(eg.builder(), &document_builder::start_mapping, &document_builder::end_mapping))
+  {
+    eg.release();
+    sg.release();
+    return true;
+  }
+  return false;
+}
+
+bool block_collection_entries::next(document_builder &builder)
+{
+  if(d_ended)
+    return false;
+
+  state_guard sg(d_ctx);
+  d_ctx.set_indent(d_indent);
+
+  if(d_entry(d_ctx, builder))
+  {
+    // as in parse_entries, stop when an entry consumed nothing
+    char_stream::mark_t mark = d_ctx.stream().mark();
+    if(mark > d_mark)
+    {
+      d_mark = mark;
+      return true;
+    }
+  }
+
+  (builder.*d_end)(d_ctx);
+  d_ended = true;
+  return false;
+}
+
+// the same as block_sequence and block_mapping, up to the first entry
+template <typename collection_entry_t>
+bool block_collection_entries::start(document_builder &builder, collection_event start, collection_event end)
+{
+  state_guard stg(d_ctx);
+  stream_guard sg(d_ctx);
+  event_guard eg(builder);
+
+  int n = d_ctx.indent_level();
+  int d = internal::delta_indent(d_ctx);
+  int m = d - n;
+
+  if(m <= 0)
+    return false;
+
+  d_ctx.set_indent(n + m);
+  (eg.builder().*start)(d_ctx);
+  if(!collection_entry_t::parse(d_ctx, eg, builder))
+    return false;
+  sg.release();
+
+  d_indent = n + m;
+  d_entry = &parse_entry<collection_entry_t>;
+  d_end = end;
+  d_mark = d_ctx.stream().mark();
+  return true;
+}
@@ -70,10 +70,11 @@ namespace kyaml
 
     // [169] 	l-trail-comments(n) 	::= 	s-indent(<n) c-nb-comment-text b-comment
     //                                          l-comment* 
-    typedef internal::all_of<indent_clause_lt,
-                             non_break_comment_text,
-                             break_comment,
-                             internal::zero_or_more<line_comment> > trail_comments;
+    // these are no content, they don't end up in the scalar
+    typedef internal::silent<internal::all_of<indent_clause_lt,
+                                              non_break_comment_text,
+                                              break_comment,
+                                              internal::zero_or_more<line_comment> > > trail_comments;
 
     // [168] 	l-keep-empty(n) 	::= 	l-empty(n,block-in)*
     //                                          l-trail-comments(n)? 
@@ -100,7 +101,7 @@ namespace kyaml
     //                                    s-indent(n) nb-char+
     typedef internal::all_of<internal::zero_or_more<internal::state_scope<internal::flow_modifier<context::BLOCK_IN>, empty_line> >,
                              internal::indent_clause_ge,
-                             internal::one_or_more<non_break_char> > line_literal_text;
+                             internal::verbatim<internal::one_or_more<non_break_char> > > line_literal_text;
 
     // [172] 	b-nb-literal-next(n) 	::= 	b-as-line-feed
     //                                          l-nb-literal-text(n) 	 
@@ -131,7 +132,7 @@ namespace kyaml
     // [175] 	s-nb-folded-text(n) 	::= 	s-indent(n) ns-char nb-char* 
     typedef internal::all_of<indent_clause_eq,
                              non_white_char,
-                             internal::zero_or_more<non_break_char> > folded_text;
+                             internal::verbatim<internal::zero_or_more<non_break_char> > > folded_text;
 
     // [176] 	l-nb-folded-lines(n) 	::= 	s-nb-folded-text(n)
     //                                          ( b-l-folded(n,block-in) s-nb-folded-text(n) )* 
@@ -142,7 +143,7 @@ namespace kyaml
     // [177] 	s-nb-spaced-text(n) 	::= 	s-indent(n) s-white nb-char* 
     typedef internal::all_of<internal::indent_clause_ge,
                              white,
-                             internal::zero_or_more<non_break_char> > spaced_text;
+                             internal::verbatim<internal::zero_or_more<non_break_char> > > spaced_text;
 
     // [178] 	b-l-spaced(n) 	::= 	b-as-line-feed
     //                                  l-empty(n,block-in)* 
@@ -208,6 +209,8 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr bool all_or_nothing = true;
+
       bool parse(document_builder &builder);
     };
 
@@ -234,7 +237,7 @@ namespace kyaml
                              sline_comment> flow_in_block;
 
     // [196] 	s-l+block-node(n,c) 	::= 	s-l+block-in-block(n,c) | s-l+flow-in-block(n)
-    typedef internal::or_clause<block_in_block, flow_in_block> block_node;
+    typedef internal::memoize<internal::or_clause<block_in_block, flow_in_block> > block_node;
 
     // [195] 	ns-l-compact-mapping(n) 	::= 	ns-l-block-map-entry(n)
     //                                                  ( s-indent(n) ns-l-block-map-entry(n) )* 
@@ -249,9 +252,9 @@ namespace kyaml
 
     // [194] 	c-l-block-map-implicit-value(n) 	::= 	“:” ( s-l+block-node(n,block-out)
     //                                                              | ( e-node s-l-comments ) ) 
-    typedef internal::and_clause<internal::simple_char_clause<':', false>,
-                                 internal::or_clause<internal::state_scope<internal::flow_modifier<context::BLOCK_OUT>, block_node>,
-                                                     internal::and_clause<enode, sline_comment> > > block_map_implicit_value;
+    // the node after the “:”
+    typedef internal::or_clause<internal::state_scope<internal::flow_modifier<context::BLOCK_OUT>, block_node>,
+                                internal::and_clause<enode, sline_comment> > block_map_implicit_node;
 
     // [193] 	ns-s-block-map-implicit-key 	::= 	  c-s-implicit-json-key(block-key)
     //                                                  | ns-s-implicit-yaml-key(block-key)
@@ -262,9 +265,12 @@ namespace kyaml
     // [192] 	ns-l-block-map-implicit-entry(n) 	::= 	( ns-s-block-map-implicit-key
     //                                                            | e-node )
     //                                                          c-l-block-map-implicit-value(n)
+    // up to and including the “:”, nothing but an implicit entry starts like this
     typedef internal::and_clause<internal::or_clause<block_map_implicit_key,
                                                      enode>,
-                                 block_map_implicit_value> block_map_implicit_entry;
+                                 internal::simple_char_clause<':', false> > block_map_implicit_head;
+    typedef internal::and_clause<block_map_implicit_head,
+                                 block_map_implicit_node> block_map_implicit_entry;
 
     // [185] 	s-l+block-indented(n,c) 	::= 	  ( s-indent(m)
     //                                            (   ns-l-compact-sequence(n+1+m)
@@ -308,10 +314,12 @@ namespace kyaml
 
     // [184] 	c-l-block-seq-entry(n) 	::= 	“-” /* Not followed by an ns-char */
     //                                          s-l+block-indented(n,block-in)
-    typedef internal::all_of<internal::simple_char_clause<'-', false>,
-                             internal::not_clause<non_white_char>,
-                             internal::state_scope<internal::flow_modifier<context::BLOCK_IN>, block_indented>
-                            > block_seq_entry;
+    // the “-”, nothing but an entry starts like this
+    typedef internal::and_clause<internal::simple_char_clause<'-', false>,
+                                 internal::not_clause<non_white_char> > block_seq_indicator;
+    typedef internal::state_scope<internal::flow_modifier<context::BLOCK_IN>, block_indented> block_seq_node;
+    typedef internal::and_clause<block_seq_indicator,
+                                 block_seq_node> block_seq_entry;
 
     // [186] 	ns-l-compact-sequence(n) 	::= 	c-l-block-seq-entry(n)
     //                                                  ( s-indent(n) c-l-block-seq-entry(n) )* 
@@ -330,6 +338,10 @@ namespace kyaml
     public:
       using clause::clause;
 
+      // a failing entry may have been forwarded, but only in a document that is invalid anyway,
+      // see parse_entries
+      static constexpr bool all_or_nothing = true;
+
       bool parse(document_builder &builder);
     };
     
@@ -340,8 +352,40 @@ namespace kyaml
     public:
       using clause::clause;
 
+      // as block_sequence
+      static constexpr bool all_or_nothing = true;
+
       bool parse(document_builder &builder);
     };
+
+    // s-l+block-collection(n,c) taken one entry at a time, for callers that want the events of
+    // each entry before the next one is read. Parses exactly what block_collection would.
+    class block_collection_entries : private no_copy
+    {
+    public:
+      block_collection_entries(context &ctx);
+
+      // the start of the collection and its first entry. Nothing is consumed if there is no
+      // block collection here.
+      bool start(document_builder &builder);
+
+      // the next entry. False if there are no more, then the end of the collection is added instead.
+      bool next(document_builder &builder);
+
+    private:
+      typedef bool (*entry_t)(context &ctx, document_builder &builder);
+      typedef void (document_builder::*collection_event)(document_builder::context const &);
+
+      template <typename collection_entry_t>
+      bool start(document_builder &builder, collection_event start, collection_event end);
+
+      context &d_ctx;
+      int d_indent;
+      entry_t d_entry;
+      collection_event d_end;
+      char_stream::mark_t d_mark;
+      bool d_ended;
+    };
   }
 }
 
@@ -0,0 +1,110 @@
+#ifndef CHAR_CLASS_HH
+#define CHAR_CLASS_HH
+
+#include <array>
+#include <cstdint>
+#include "char_stream.hh"
+#include "utils.hh"
+
+namespace kyaml
+{
+  // classification of characters as used by the character clauses. Single byte characters are
+  // looked up in a table, multi-byte characters are in the classes below if they are valid utf8.
+  namespace char_class
+  {
+    typedef uint16_t mask_t;
+
+    enum : mask_t
+    {
+      PRINTABLE      = 1 << 0,  // c-printable
+      JSON           = 1 << 1,  // nb-json
+      NON_BREAK      = 1 << 2,  // nb-char
+      NON_WHITE      = 1 << 3,  // ns-char
+      BREAK          = 1 << 4,  // b-char
+      WHITE          = 1 << 5,  // s-white
+      INDICATOR      = 1 << 6,  // c-indicator
+      FLOW_INDICATOR = 1 << 7,  // c-flow-indicator
+      RESERVED       = 1 << 8,  // c-reserved
+      DEC_DIGIT      = 1 << 9,  // ns-dec-digit
+      HEX_DIGIT      = 1 << 10, // ns-hex-digit
+      ASCII_LETTER   = 1 << 11, // ns-ascii-letter
+      WORD           = 1 << 12, // ns-word-char
+      URI            = 1 << 13, // ns-uri-char, except for the %-escapes
+    };
+
+    // the classes of valid multi-byte characters
+    constexpr mask_t multibyte = PRINTABLE | JSON | NON_BREAK | NON_WHITE;
+
+    constexpr std::array<mask_t, 256> make_table()
+    {
+      std::array<mask_t, 256> table{};
+
+      for(unsigned c = 0; c < 0x80; ++c)
+      {
+        mask_t m = 0;
+
+        const bool printable = c == 0x9 || c == 0xa || c == 0xd || (c >= 0x20 && c <= 0x7e);
+        const bool brk = c == '\n' || c == '\r';
+        const bool white = c == ' ' || c == '\t';
+        const bool digit = c >= '0' && c <= '9';
+        const bool letter = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+
+        if(printable)
+          m |= PRINTABLE;
+        if(c == 0x9 || c >= 0x20)
+          m |= JSON;
+        if(printable && !brk)
+          m |= NON_BREAK;
+        if(printable && !brk && !white)
+          m |= NON_WHITE;
+        if(brk)
+          m |= BREAK;
+        if(white)
+          m |= WHITE;
+        if(digit)
+          m |= DEC_DIGIT;
+        if(digit || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))
+          m |= HEX_DIGIT;
+        if(letter)
+          m |= ASCII_LETTER;
+        if(digit || letter || c == '-')
+          m |= WORD;
+
+        table[c] = m;
+      }
+
+      // note: “|” is left out, so it can start a plain scalar
+      for(char const *p = "-?:,[]{}#&*!>'\"%@`"; *p; ++p)
+        table[static_cast<uint8_t>(*p)] |= INDICATOR;
+      for(char const *p = ",[]{}"; *p; ++p)
+        table[static_cast<uint8_t>(*p)] |= FLOW_INDICATOR;
+      for(char const *p = "@`"; *p; ++p)
+        table[static_cast<uint8_t>(*p)] |= RESERVED;
+      for(char const *p = "#;/?:@&=+$,_.!~*'()[]"; *p; ++p)
+        table[static_cast<uint8_t>(*p)] |= URI;
+      for(unsigned c = 0; c < 0x80; ++c)
+        if(table[c] & WORD)
+          table[c] |= URI;
+
+      // bytes from 0x80 are never characters on their own
+      return table;
+    }
+
+    inline constexpr std::array<mask_t, 256> table = make_table();
+
+    inline mask_t classify(char_t c)
+    {
+      if(c < table.size())
+        return table[c];
+      return is_valid_utf8(c) ? multibyte : 0;
+    }
+
+    // true if c is in any of the classes in m
+    inline bool is(char_t c, mask_t m)
+    {
+      return (classify(c) & m) != 0;
+    }
+  }
+}
+
+#endif // CHAR_CLASS_HH
@@ -1,4 +1,5 @@
 #include "char_clauses.hh"
+#include "char_class.hh"
 
 using namespace std;
 using namespace kyaml;
@@ -6,52 +7,45 @@ using namespace kyaml::clauses;
 
 static_assert(sizeof(char_t) == 4, "");
 
-bool printable::parse(document_builder &builder)
+namespace
 {
-  char_t c;
-  if(!ctx().stream().peek(c))
-    return false;
-  if(c == '\x9' ||
-     c == '\xa' ||
-     c == '\xd' ||
-     (c >= '\x20' && c <= '\x7e') ||
-     c == static_cast<char_t>('\x85'))
+  const char_t byte_order_mark_v = 0x0000feff;
+
+  // accept the next character if it is in any of the classes in m
+  bool parse_class(context &ctx, document_builder &builder, char_class::mask_t m)
   {
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
+    char_t c;
+    if(ctx.stream().peek(c) && char_class::is(c, m))
+    {
+      builder.add_atom(ctx, c);
+      ctx.stream().advance();
+      return true;
+    }
+    return false;
   }
-  else if(c >= 0xff && is_valid_utf8(c))
+
+  // nb-char and ns-char also exclude the byte order mark
+  bool parse_class_nobom(context &ctx, document_builder &builder, char_class::mask_t m)
   {
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
+    char_t c;
+    if(ctx.stream().peek(c) && c != byte_order_mark_v && char_class::is(c, m))
+    {
+      builder.add_atom(ctx, c);
+      ctx.stream().advance();
+      return true;
+    }
+    return false;
   }
+}
 
-  return false;
+bool printable::parse(document_builder &builder)
+{
+  return parse_class(ctx(), builder, char_class::PRINTABLE);
 }
 
 bool json::parse(document_builder &builder)
 {
-  char_t c;
-  if(!ctx().stream().peek(c))
-    return false;
-
-  if(c == '\x9' ||
-     (c >= '\x20' && c <= '\x7f'))
-  {
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
-  }
-  else if(c >= 0xff && is_valid_utf8(c))
-  {
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
-  }
-
-  return false;
+  return parse_class(ctx(), builder, char_class::JSON);
 }
 
 bool byte_order_mark::parse(document_builder &builder)
@@ -65,7 +59,7 @@ bool byte_order_mark::inner::parse(document_builder &builder)
   char_t c;
   if(!ctx().stream().peek(c))
     return false;
-  if(c == 0x0000feff)
+  if(c == byte_order_mark_v)
   {
     builder.add_atom(ctx(), c);
     ctx().stream().advance();
@@ -124,178 +118,47 @@ bool mapping_end::parse(document_builder &builder)
 
 bool reserved::parse(document_builder &builder)
 {
-  char_t c;
-  if(ctx().stream().peek(c) &&
-     ( c == '@' || c == '`' ))
-  {
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
-  }
-  return false;
+  return parse_class(ctx(), builder, char_class::RESERVED);
 }
 
 bool indicator::parse(document_builder &builder)
 {
-  char_t c = 0;
-  ctx().stream().peek(c);
-
-  switch(c)
-  {
-  case '-':
-  case '?':
-  case ':':
-  case ',':
-  case '[':
-  case ']':
-  case '{':
-  case '}':
-  case '#':
-  case '&':
-  case '*':
-  case '!':
-  case '>':
-  case '\'':
-  case '"':
-  case '%':
-  case '@':
-  case '`':
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
-
-  default:
-    return false;
-  }
+  return parse_class(ctx(), builder, char_class::INDICATOR);
 }
 
 bool flow_indicator::parse(document_builder &builder)
 {
-  char_t c = 0;
-  ctx().stream().peek(c);
-  
-  switch(c)
-  {
-  case ',':
-  case '[':
-  case ']':
-  case '{':
-  case '}':
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
-
-  default:
-    return false;
-  }
+  return parse_class(ctx(), builder, char_class::FLOW_INDICATOR);
 }
 
 bool non_break_char::parse(document_builder &builder)
 {
-  stream_guard sg(ctx());
-
-  null_builder dm;
-  break_char bc(ctx());
-  if(bc.parse(dm))
-    return false;
-
-  byte_order_mark bo(ctx());
-  if(bo.parse(dm))
-    return false;
-
-  printable pr(ctx());
-  if(pr.parse(builder))
-  {
-    sg.release();
-    return true;
-  }
-  return false;
+  return parse_class_nobom(ctx(), builder, char_class::NON_BREAK);
 }
 
 bool non_white_char::parse(document_builder &builder)
 {
-  stream_guard sg(ctx());
-
-  null_builder dm;
-  white w(ctx());
-  if(w.parse(dm))
-    return false;
-
-  non_break_char nb(ctx());
-  if(nb.parse(builder))
-  {
-    sg.release();
-    return true;
-  }
-  return false;
+  return parse_class_nobom(ctx(), builder, char_class::NON_WHITE);
 }
 
 bool dec_digit_char::parse(document_builder &builder)
 {
-  char_t c;
-  if(ctx().stream().peek(c) &&
-     (c >= '0' && c <= '9'))
-  {
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
-  }
-  return false;
+  return parse_class(ctx(), builder, char_class::DEC_DIGIT);
 }
 
 bool hex_digit_char::parse(document_builder &builder)
 {
-  dec_digit_char d(ctx());
-  if(d.parse(builder))
-    return true;
-  else
-  {
-    char_t c;
-    if(ctx().stream().peek(c) &&
-       ((c >= 'a' && c <= 'f') ||
-        (c >= 'A' && c <= 'F')))
-    {
-      builder.add_atom(ctx(), c);
-      ctx().stream().advance();
-      return true;
-    }
-  }
-  return false;
+  return parse_class(ctx(), builder, char_class::HEX_DIGIT);
 }
 
 bool ascii_letter::parse(document_builder &builder)
 {
-  char_t c;
-  if(ctx().stream().peek(c) &&
-     ((c >= 'a' && c <= 'z') ||
-      (c >= 'A' && c <= 'Z')))
-  {
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
-  }
-  return false;
+  return parse_class(ctx(), builder, char_class::ASCII_LETTER);
 }
 
 bool word_char::parse(document_builder &builder)
 {
-  dec_digit_char d(ctx());
-  if(d.parse(builder))
-    return true;
-  
-  ascii_letter a(ctx());
-  if(a.parse(builder))
-    return true;
-  
-  char_t c;
-  if(ctx().stream().peek(c) &&
-     c == '-')
-  {
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
-  }
-  return false;
+  return parse_class(ctx(), builder, char_class::WORD);
 }
 
 bool uri_char::parse(document_builder &builder)
@@ -306,10 +169,6 @@ bool uri_char::parse(document_builder &builder)
 
 bool uri_char::inner::parse(document_builder &builder)
 {
-  word_char wc(ctx());
-  if(wc.parse(builder))
-    return true;
-
   char_t c;
   if(!ctx().stream().peek(c))
     return false;
@@ -324,36 +183,7 @@ bool uri_char::inner::parse(document_builder &builder)
     return h1.parse(builder) && h2.parse(builder);
   }
 
-  switch(c)
-  {
-  case '#':
-  case ';':
-  case '/':
-  case '?':
-  case ':':
-  case '@':
-  case '&':
-  case '=':
-  case '+':
-  case '$':
-  case ',':
-  case '_':
-  case '.':
-  case '!':
-  case '~':
-  case '*':
-  case '\'':
-  case '(':
-  case ')':
-  case '[':
-  case ']':
-    builder.add_atom(ctx(), c);
-    ctx().stream().advance();
-    return true;
-
-  default:
-    return false;
-  } 
+  return parse_class(ctx(), builder, char_class::URI);
 }
 
 bool tag_char::parse(document_builder &builder)
@@ -17,8 +17,13 @@ namespace kyaml
       {
       public:
         using clause::clause;
-     
-        bool parse(document_builder &builder)
+
+        static constexpr char_set first_chars = char_set::single(char_value);
+        static constexpr bool nullable = false;
+        static constexpr bool all_or_nothing = true;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           char_t c;
           if(ctx().stream().peek(c) && c == char_value)
@@ -104,6 +109,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "[";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
     };
 
@@ -113,6 +121,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "]";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
     };
 
@@ -122,6 +133,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "{";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
     };
 
@@ -131,6 +145,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "}";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
     };
 
@@ -167,6 +184,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "@`";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
 
       char const *name() const
@@ -183,6 +203,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "-?:,[]{}#&*!>\'\"%@`";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
 
       char const *name() const
@@ -197,6 +220,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = ",[]{}";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
 
       char const *name() const
@@ -221,6 +247,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = char_set::all() - "\r\n";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
 
       char const *name() const
@@ -237,6 +266,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "\r\n";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
     };
 
@@ -246,6 +278,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "\r\n";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
     };
 
@@ -255,6 +290,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "\r\n";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
     };
 
@@ -273,6 +311,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = char_set::all() - " \t\r\n";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
 
       char const *name() const
@@ -287,6 +328,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = char_set::range('0', '9');
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
 
       char const *name() const
@@ -302,6 +346,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = char_set::range('0', '9') | char_set::range('a', 'f') | char_set::range('A', 'F');
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
 
       char const *name() const
@@ -316,6 +363,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = char_set::range('a', 'z') | char_set::range('A', 'Z');
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
 
       char const *name() const
@@ -329,6 +379,9 @@ namespace kyaml
     {
     public:
       using clause::clause;
+
+      static constexpr char_set first_chars = char_set::range('0', '9') | char_set::range('a', 'z') | char_set::range('A', 'Z') | "-";
+      static constexpr bool nullable = false;
       
       bool parse(document_builder &builder);
       
@@ -384,7 +437,8 @@ namespace kyaml
       public:
         using clause::clause;
 
-        bool parse(document_builder &builder)
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           inner ic(ctx());
           return internal::try_parse(ic, builder);
@@ -458,7 +512,8 @@ namespace kyaml
         public:
           using clause::clause;
           
-          bool parse(document_builder &builder)
+          template <typename builder_t>
+          bool parse(builder_t &builder)
           {
             internal::simple_char_clause<escape, false> head(ctx());
             if(head.parse(builder))
@@ -484,7 +539,8 @@ namespace kyaml
       public:
         using clause::clause;
 
-        bool parse(document_builder &builder)
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           internal::simple_char_clause<char_v, false> d(ctx());
           if(d.parse(builder))
@@ -6,42 +6,57 @@
 using namespace std;
 using namespace kyaml;
 
+namespace
+{
+  // a character is stored as its packed utf8 bytes, so it never takes more than this
+  const size_t max_char_bytes = sizeof(char_t);
+}
+
 bool char_stream::get(char_t &c)
 {
-  if(!underflow())
+  if(!underflow(max_char_bytes) && d_pos >= d_size)
     return false;
 
-  assert(d_pos < d_buffer.size());
-
-  c = d_buffer[d_pos++];
+  d_pos += decode(d_pos, c);
+  ++d_charpos;
   return true;
 }
 
 bool char_stream::peek(char_t &c)
 {
-  if(!underflow())
+  if(!underflow(max_char_bytes) && d_pos >= d_size)
     return false;
 
-  assert(d_pos < d_buffer.size());
-
-  c = d_buffer[d_pos];
+  decode(d_pos, c);
   return true;
 }
 
 bool char_stream::rpeek(char_t &c)
 {
-  if(d_pos)
-  {
-    c = d_buffer[d_pos - 1];
-    return true;
-  }
-  return false;
+  if(!d_pos)
+    return false;
+
+  // find the start of the previous character
+  size_t start = d_pos - 1;
+  while(start > 0 &&
+        d_pos - start < max_char_bytes &&
+        is_continuation_byte(d_data[start]))
+    --start;
+
+  if(decode(start, c) != d_pos - start) // not a valid sequence, just return the byte
+    c = static_cast<uint8_t>(d_data[d_pos - 1]);
+
+  return true;
 }
 
 void char_stream::advance(size_t n)
 {
-  d_pos += n;
-  underflow();
+  for(size_t i = 0; i < n; ++i)
+  {
+    char_t c;
+    if(!get(c))
+      break;
+  }
 }
 
 char_stream::mark_t char_stream::mark() const
@@ -53,7 +68,12 @@ char_stream::mark_t char_stream::mark() const
 void char_stream::unwind(mark_t m)
 {
   assert(d_mark_valid);
-  assert(m <= d_buffer.size());
+  assert(m <= d_size);
+
+  if(m < d_pos)
+    d_charpos -= count_chars(m, d_pos);
+  else
+    d_charpos += count_chars(d_pos, m);
 
   d_pos = m;
 }
@@ -62,13 +82,7 @@ string char_stream::consume(mark_t m)
 {
   string result;
   if(m < d_pos)
-  {
-    auto begin = d_buffer.begin() + m;
-    auto end = d_buffer.begin() + d_pos;
-
-    for(auto it = begin; it != end; ++it)
-      append_utf8(result, *it);
-  }
+    result.assign(d_data + m, d_pos - m);
 
   ignore();
   return result;
@@ -76,55 +90,113 @@ string char_stream::consume(mark_t m)
 
 size_t char_stream::indent_level(size_t hint) const
 {
-  if(hint >= d_pos)
+  if(hint >= d_charpos)
     return 0;
 
-  size_t pos = d_pos - hint - 1;
-  while(pos < d_buffer.size()) // rely on overflow for termination
+  size_t count = 0;
+  size_t pos = d_pos;
+  while(pos > 0)
   {
-    char_t c = d_buffer[pos];
-    if(c == '\n' || c == '\r')
+    uint8_t c = d_data[--pos];
+    if(is_continuation_byte(c))
+      continue;
+    if(count >= hint && (c == '\n' || c == '\r'))
       break;
-    --pos;
+    ++count;
   }
 
-  return d_pos - pos - 1;
+  return count;
 }
 
 void char_stream::ignore()
 {
-  d_buffer.erase(d_buffer.begin(), d_buffer.begin() + d_pos);
+  if(d_base)
+  {
+    d_buffer.erase(0, d_pos);
+    d_data = d_buffer.data();
+    d_size = d_buffer.size();
+  }
+  else
+  {
+    d_data += d_pos;
+    d_size -= d_pos;
+  }
 
   d_pos = 0;
+  d_charpos = 0;
   d_mark_valid = false;
 }
 
 void char_stream::ignore(char c)
 {
-  while(true)
+  size_t found = string_view(d_data, d_size).find(c, d_pos);
+  if(found != string_view::npos)
   {
-    if(d_pos >= d_buffer.size())
-      break;
-    else if(d_buffer[d_pos] == (char_t)c)
-      return;
-    else
-      ++d_pos;
+    d_charpos += count_chars(d_pos, found);
+    d_pos = found;
+    return;
   }
 
+  d_pos = d_size;
   ignore();
-  d_base.ignore(numeric_limits<streamsize>::max(), c);
+  if(d_base)
+    d_base->ignore(numeric_limits<streamsize>::max(), c);
 }
 
-bool char_stream::underflow()
+bool char_stream::underflow(size_t n)
 {
-  while(d_buffer.size() <= d_pos)
+  while(d_size - d_pos < n)
   {
-    char32_t c;
-    if(extract_utf8(d_base, c))
-      d_buffer.push_back(c);
-    else
+    if(!d_base || !d_base->good())
       return false;
+
+    size_t size = d_buffer.size();
+    d_buffer.resize(size + s_block_size);
+    d_base->read(&d_buffer[size], s_block_size);
+    d_buffer.resize(size + d_base->gcount());
+
+    d_data = d_buffer.data();
+    d_size = d_buffer.size();
   }
 
   return true;
 }
+
+size_t char_stream::decode(size_t pos, char_t &c) const
+{
+  assert(pos < d_size);
+
+  uint8_t byte = d_data[pos];
+  c = byte;
+
+  size_t len = 1;
+  if(is_lead_byte(byte))
+  {
+    size_t n = nr_utf8bytes(byte);
+    if(n == 0 || n > max_char_bytes)
+      n = max_char_bytes;
+
+    while(len < n &&
+          pos + len < d_size &&
+          is_continuation_byte(d_data[pos + len]))
+    {
+      c <<= 8;
+      c |= static_cast<uint8_t>(d_data[pos + len]);
+      ++len;
+    }
+  }
+
+  return len;
+}
+
+size_t char_stream::count_chars(size_t from, size_t to) const
+{
+  size_t count = 0;
+  while(from < to)
+  {
+    char_t c;
+    from += decode(from, c);
+    ++count;
+  }
+  return count;
+}
@@ -2,21 +2,38 @@
 #define CHAR_STREAM_HH
 
 #include <istream>
-#include <deque>
 #include <string>
+#include <string_view>
 
 namespace kyaml
 {
   typedef char32_t char_t;
 
+  // character stream on top of a contiguous byte buffer. The underlying stream is read in
+  // large blocks, characters are decoded from the buffer on demand. Marks are plain byte offsets
+  // into the buffer, the buffer is only compacted on consume() or ignore().
+  // Alternatively the stream can work directly on a caller-owned buffer, which then has to
+  // outlive the stream.
   class char_stream
   {
   public:
     typedef size_t mark_t;
 
-    char_stream(std::istream &base) : 
-      d_base(base),
+    char_stream(std::istream &base) :
+      d_base(&base),
+      d_data(nullptr),
+      d_size(0),
       d_pos(0),
+      d_charpos(0),
+      d_mark_valid(false)
+    {}
+
+    char_stream(std::string_view buffer) :
+      d_base(nullptr),
+      d_data(buffer.data()),
+      d_size(buffer.size()),
+      d_pos(0),
+      d_charpos(0),
       d_mark_valid(false)
     {}
 
@@ -34,7 +51,7 @@ namespace kyaml
     // mark the current position in the stream
     mark_t mark() const;
 
-    // unwind the stream, setting the read pos back to m. 
+    // unwind the stream, setting the read pos back to m.
     void unwind(mark_t m);
 
     // purge all buffers until pos(), will invalidate marks
@@ -46,24 +63,37 @@ namespace kyaml
     // that this invalidates all marks previously returned by mark().
     std::string consume(mark_t m = 0);
 
-    // mostly for diagnostic purposes
-    mark_t pos() const
+    // the raw bytes from m to the current read pos, valid until the next read or ignore()
+    std::string_view view(mark_t m) const
+    {
+      return m < d_pos ? std::string_view(d_data + m, d_pos - m) : std::string_view();
+    }
+
+    // mostly for diagnostic purposes, the number of characters read since the last consume() or ignore()
+    size_t pos() const
     {
-      return d_pos;
+      return d_charpos;
+    }
+
+    // the caller-owned buffer, views into it stay valid as long as it does. Empty when reading
+    // from a std::istream, as those bytes move around.
+    std::string_view source() const
+    {
+      return d_base ? std::string_view() : std::string_view(d_data, d_size);
     }
 
     bool good() const
     {
-      return 
-        d_pos < d_buffer.size() ||
-        d_base.good();
+      return
+        d_pos < d_size ||
+        (d_base && d_base->good());
     }
 
     bool eof() const
     {
-      return 
-        d_pos >= d_buffer.size() &&
-        d_base.eof();
+      return
+        d_pos >= d_size &&
+        (!d_base || d_base->eof());
     }
 
     // return the indent level, that is the number of chars since the last newline (\r or \n). or start of file
@@ -72,12 +102,24 @@ namespace kyaml
     size_t indent_level(size_t hint = 0) const;
 
   private:
-    bool underflow();
+    // make sure at least n bytes are available from the read pos, returns false if not possible
+    bool underflow(size_t n = 1);
+
+    // decode the character at byte offset pos, returns the number of bytes it occupies
+    size_t decode(size_t pos, char_t &c) const;
+
+    // number of characters in the byte range [from, to)
+    size_t count_chars(size_t from, size_t to) const;
+
+    static const size_t s_block_size = 64 * 1024;
 
-    std::istream      &d_base;
-    std::deque<char_t> d_buffer;
-    mark_t             d_pos;
-    mutable bool       d_mark_valid; // only for additional run-time error checking
+    std::istream *d_base;   // nullptr when working on a caller-owned buffer
+    std::string   d_buffer; // storage for what was read from d_base
+    char const   *d_data;   // the bytes available, either d_buffer or the caller's buffer
+    size_t        d_size;
+    mark_t        d_pos;
+    size_t        d_charpos;
+    mutable bool  d_mark_valid; // only for additional run-time error checking
   };
 }
 
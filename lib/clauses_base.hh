@@ -2,13 +2,100 @@
 #define CLAUSES_BASE_HH
 
 #include <sstream>
+#include <cstdint>
+#include <type_traits>
 #include "context.hh"
 #include "document_builder.hh"
+#include "memo_table.hh"
 
 namespace kyaml
 {
   namespace clauses
   {
+    // a set of characters, exact for ascii, all other characters are lumped together
+    class char_set
+    {
+    public:
+      constexpr char_set() :
+        d_lo(0),
+        d_hi(0),
+        d_other(false)
+      {}
+
+      // the ascii characters in chars
+      constexpr char_set(char const *chars) :
+        char_set()
+      {
+        for(; *chars; ++chars)
+          add(static_cast<uint8_t>(*chars));
+      }
+
+      static constexpr char_set single(char_t c)
+      {
+        char_set result;
+        result.add(c);
+        return result;
+      }
+
+      static constexpr char_set range(char_t first, char_t last)
+      {
+        char_set result;
+        for(char_t c = first; c <= last; ++c)
+          result.add(c);
+        return result;
+      }
+
+      static constexpr char_set all()
+      {
+        char_set result;
+        result.d_lo = ~uint64_t(0);
+        result.d_hi = ~uint64_t(0);
+        result.d_other = true;
+        return result;
+      }
+
+      constexpr char_set operator|(char_set const &other) const
+      {
+        char_set result;
+        result.d_lo = d_lo | other.d_lo;
+        result.d_hi = d_hi | other.d_hi;
+        result.d_other = d_other || other.d_other;
+        return result;
+      }
+
+      constexpr char_set operator-(char_set const &other) const
+      {
+        char_set result;
+        result.d_lo = d_lo & ~other.d_lo;
+        result.d_hi = d_hi & ~other.d_hi;
+        result.d_other = d_other && !other.d_other;
+        return result;
+      }
+
+      constexpr bool contains(char_t c) const
+      {
+        return
+          c < 64  ? (d_lo >> c) & 1 :
+          c < 128 ? (d_hi >> (c - 64)) & 1 :
+          d_other;
+      }
+
+    private:
+      constexpr void add(char_t c)
+      {
+        if(c < 64)
+          d_lo |= uint64_t(1) << c;
+        else if(c < 128)
+          d_hi |= uint64_t(1) << (c - 64);
+        else
+          d_other = true;
+      }
+
+      uint64_t d_lo;
+      uint64_t d_hi;
+      bool d_other;
+    };
+
     class clause
     {
     public:
@@ -42,6 +129,71 @@ namespace kyaml
 
     namespace internal
     {
+      // FIRST set of a clause: the characters it can start with, and whether it can succeed without
+      // consuming anything. Clauses can declare these as
+      //   static constexpr char_set first_chars;
+      //   static constexpr bool nullable;
+      // the combinators derive them from their subclauses. If not declared, anything goes.
+      template <typename clause_t, typename = void>
+      struct first_set
+      {
+        static constexpr char_set chars = char_set::all();
+        static constexpr bool nullable = true;
+
+        static constexpr bool viable(char_t c, bool eof)
+        {
+          return true;
+        }
+      };
+
+      template <typename clause_t>
+      struct first_set<clause_t, std::void_t<decltype(clause_t::first_chars)> >
+      {
+        static constexpr char_set chars = clause_t::first_chars;
+        static constexpr bool nullable = clause_t::nullable;
+
+        // could the clause succeed on a stream starting with c, or at eof
+        static constexpr bool viable(char_t c, bool eof)
+        {
+          return nullable || (!eof && chars.contains(c));
+        }
+      };
+
+      // clauses that can not fail declare
+      //   static constexpr bool infallible = true;
+      template <typename clause_t, typename = void>
+      struct is_infallible : std::false_type
+      {};
+
+      template <typename clause_t>
+      struct is_infallible<clause_t, std::void_t<decltype(clause_t::infallible)> > :
+        std::integral_constant<bool, clause_t::infallible>
+      {};
+
+      // clauses that add no events unless they succeed declare
+      //   static constexpr bool all_or_nothing = true;
+      // only these can write to a target that can't be rolled back
+      template <typename clause_t, typename = void>
+      struct is_all_or_nothing : std::false_type
+      {};
+
+      template <typename clause_t>
+      struct is_all_or_nothing<clause_t, std::void_t<decltype(clause_t::all_or_nothing)> > :
+        std::integral_constant<bool, clause_t::all_or_nothing>
+      {};
+
+      // for a sequence of clauses
+      template <typename head_t, typename... tail_t>
+      constexpr char_set sequence_first()
+      {
+        if constexpr(sizeof...(tail_t) == 0)
+          return first_set<head_t>::chars;
+        else if constexpr(first_set<head_t>::nullable)
+          return first_set<head_t>::chars | sequence_first<tail_t...>();
+        else
+          return first_set<head_t>::chars;
+      }
+
       // +
       template <typename subclause_t>
       class one_or_more : public clause
@@ -49,7 +201,12 @@ namespace kyaml
       public:
         using clause::clause;
 
-        bool parse(document_builder &builder)
+        static constexpr char_set first_chars = first_set<subclause_t>::chars;
+        static constexpr bool nullable = first_set<subclause_t>::nullable;
+        static constexpr bool all_or_nothing = is_all_or_nothing<subclause_t>::value;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           if(parse_once(builder))
           {
@@ -68,7 +225,8 @@ namespace kyaml
         }
 
       private:
-        bool parse_once(document_builder &builder)
+        template <typename builder_t>
+        bool parse_once(builder_t &builder)
         {
           subclause_t s(clause::ctx());
           return s.parse(builder);
@@ -81,8 +239,14 @@ namespace kyaml
       {
       public:
         using clause::clause;
-        
-        bool parse(document_builder &builder)
+
+        static constexpr char_set first_chars = first_set<subclause_t>::chars;
+        static constexpr bool nullable = true;
+        static constexpr bool infallible = true;
+        static constexpr bool all_or_nothing = true;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           char_stream::mark_t before = clause::ctx().stream().mark();
           while(parse_once(builder))
@@ -97,7 +261,8 @@ namespace kyaml
         }
 
       private:
-        bool parse_once(document_builder &builder)
+        template <typename builder_t>
+        bool parse_once(builder_t &builder)
         {
           subclause_t s(clause::ctx());
           return s.parse(builder);
@@ -111,45 +276,69 @@ namespace kyaml
       public:
         using clause::clause;
 
-        bool parse(document_builder &builder)
+        static constexpr char_set first_chars = first_set<subclause_t>::chars;
+        static constexpr bool nullable = true;
+        static constexpr bool infallible = true;
+        static constexpr bool all_or_nothing = true;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           parse_once(builder);
           return true;
         }
 
       private:
-        bool parse_once(document_builder &builder)
+        template <typename builder_t>
+        bool parse_once(builder_t &builder)
         {
           subclause_t s(clause::ctx());
           return s.parse(builder);
         }
       };
       
+      // alternatives that can be ruled out by their FIRST set are skipped after a single peek()
       template <typename... clauses_t>
       class any_of : public clause
       {
       public:
         using clause::clause;
 
-        bool parse(document_builder &builder)
+        static constexpr char_set first_chars = (first_set<clauses_t>::chars | ...);
+        static constexpr bool nullable = (first_set<clauses_t>::nullable || ...);
+        static constexpr bool all_or_nothing = (is_all_or_nothing<clauses_t>::value && ...);
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
-          return parse_recurse<clauses_t...>(builder);
+          char_t c = 0;
+          bool eof = false;
+          if constexpr(s_selective)
+            eof = !clause::ctx().stream().peek(c);
+
+          return parse_recurse<builder_t, clauses_t...>(builder, c, eof);
         }
 
       private:
-        template <typename head_t>
-        bool parse_recurse(document_builder &builder)
+        // true if any of the alternatives can be ruled out up front
+        static constexpr bool s_selective = (!first_set<clauses_t>::nullable || ...);
+
+        template <typename builder_t, typename head_t>
+        bool parse_recurse(builder_t &builder, char_t c, bool eof)
         {
+          if(!first_set<head_t>::viable(c, eof))
+            return false;
+
           head_t head(clause::ctx());
           return head.parse(builder);
         }
         
-        template <typename head_t, typename head2_t, typename... tail_t>
-        bool parse_recurse(document_builder &builder)
+        template <typename builder_t, typename head_t, typename head2_t, typename... tail_t>
+        bool parse_recurse(builder_t &builder, char_t c, bool eof)
         {
           return
-            parse_recurse<head_t>(builder) ||
-            parse_recurse<head2_t, tail_t...>(builder);
+            parse_recurse<builder_t, head_t>(builder, c, eof) ||
+            parse_recurse<builder_t, head2_t, tail_t...>(builder, c, eof);
         }        
       };
 
@@ -158,35 +347,51 @@ namespace kyaml
       {
       public:
         using clause::clause;
-        
-        bool parse(document_builder &builder)
+
+        static constexpr char_set first_chars = sequence_first<clauses_t...>();
+        static constexpr bool nullable = (first_set<clauses_t>::nullable && ...);
+        static constexpr bool all_or_nothing = true;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           stream_guard sg(ctx());
 
-          replay_builder rb;
-          if(parse_recurse<clauses_t...>(rb))
+          if constexpr(discards_v<builder_t>)
           {
-            rb.replay(builder);
-            sg.release();
-            return true;
+            // nothing to roll back
+            if(!(clauses_t(ctx()).parse(builder) && ...))
+              return false;
           }
-          return false;
+          else
+          {
+            event_guard eg(builder);
+            if(!parse_recurse<clauses_t...>(eg))
+              return false;
+            eg.release();
+          }
+
+          sg.release();
+          return true;
         }
 
       private:
-        template <typename head_t>
-        bool parse_recurse(document_builder &builder)
+        template <typename head_t, typename... tail_t>
+        bool parse_recurse(event_guard &eg)
         {
+          // once the remaining clauses can't fail and nothing was logged yet, there is nothing to
+          // roll back and the events can go straight to the target. Unless this clause can fail
+          // after adding some.
+          constexpr bool tail = is_all_or_nothing<head_t>::value && (is_infallible<tail_t>::value && ...);
+
           head_t head(clause::ctx());
-          return head.parse(builder);
-        }
-        
-        template <typename head_t, typename head2_t, typename... tail_t>
-        bool parse_recurse(document_builder &builder)
-        {
-          return
-            parse_recurse<head_t>(builder) &&
-            parse_recurse<head2_t, tail_t...>(builder);
+          if(!head.parse(tail ? eg.tail_builder() : eg.builder()))
+            return false;
+
+          if constexpr(sizeof...(tail_t) > 0)
+            return parse_recurse<tail_t...>(eg);
+          else
+            return true;
         }
       };
 
@@ -212,7 +417,13 @@ namespace kyaml
       public:
         using clause::clause;
 
-        bool parse(document_builder &builder)
+        // never consumes anything
+        static constexpr char_set first_chars = char_set();
+        static constexpr bool nullable = true;
+        static constexpr bool all_or_nothing = true;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           stream_guard sg(ctx());
           null_builder db;
@@ -230,7 +441,11 @@ namespace kyaml
       public:
         using clause_t::clause_t;
 
-        bool parse(document_builder &builder)
+        // even if clause_t can't fail, this can
+        static constexpr bool infallible = false;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           return
             clause_t::ctx().blockflow() == blockflow_v &&
@@ -238,29 +453,141 @@ namespace kyaml
         }
       };
 
+      // parse without emitting any events
       template <typename clause_t>
-      bool try_parse(clause_t &cl, document_builder &builder)
+      class silent : public clause
       {
-        context_guard cg(cl.ctx());
+      public:
+        using clause::clause;
+
+        static constexpr char_set first_chars = first_set<clause_t>::chars;
+        static constexpr bool nullable = first_set<clause_t>::nullable;
+        static constexpr bool all_or_nothing = true;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
+        {
+          null_builder nb;
+          return clause_t(ctx()).parse(nb);
+        }
+      };
+
+      // for clauses that emit exactly the characters they consume, as atoms: the characters are
+      // emitted as a single run of text instead
+      template <typename clause_t>
+      class verbatim : public clause
+      {
+      public:
+        using clause::clause;
 
-        replay_builder rb;
-        if(cl.parse(rb))
+        static constexpr char_set first_chars = first_set<clause_t>::chars;
+        static constexpr bool nullable = first_set<clause_t>::nullable;
+        static constexpr bool all_or_nothing = true;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
-          rb.replay(builder);
-          cg.release();
+          const char_stream::mark_t start = ctx().stream().mark();
+
+          null_builder nb;
+          if(!clause_t(ctx()).parse(nb))
+            return false;
+
+          std::string_view text = ctx().stream().view(start);
+          if(!text.empty() && !builder.discards())
+            builder.add_text(ctx(), text);
           return true;
         }
+      };
 
-        return false;
+      template <typename clause_t, typename builder_t>
+      bool try_parse(clause_t &cl, builder_t &builder)
+      {
+        context_guard cg(cl.ctx());
+
+        if constexpr(discards_v<builder_t>)
+        {
+          if(!cl.parse(builder))
+            return false;
+        }
+        else
+        {
+          event_guard eg(builder);
+          if(!cl.parse(eg.builder()))
+            return false;
+          eg.release();
+        }
+
+        cg.release();
+        return true;
       }
       
+      // packrat memoization of clause_t, only active if the context has a memo table. Each clause is
+      // parsed at most once per stream position and state, the outcome and its events are replayed
+      // on subsequent attempts.
+      template <typename clause_t>
+      class memoize : public clause
+      {
+      public:
+        using clause::clause;
+
+        static constexpr char_set first_chars = first_set<clause_t>::chars;
+        static constexpr bool nullable = first_set<clause_t>::nullable;
+        static constexpr bool all_or_nothing = is_all_or_nothing<clause_t>::value;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
+        {
+          memo_table *memo = ctx().memo();
+          if(!memo)
+            return clause_t(ctx()).parse(builder);
+
+          const memo_table::clause_id_t id = memo_table::id<clause_t>();
+          const char_stream::mark_t pos = ctx().stream().mark();
+          const context::state state = ctx().get_state();
+
+          memo_table::entry const *e = memo->find(id, pos, state);
+          if(!e)
+          {
+            // the table needs the events even if this builder doesn't
+            replay_builder rb;
+            event_guard eg(builder.discards() ? rb : static_cast<document_builder &>(builder));
+            bool result = clause_t(ctx()).parse(eg.builder());
+
+            memo_table::entry ne(result, ctx());
+            eg.replay(ne.events);
+            memo->insert(id, pos, state, std::move(ne));
+
+            if(result)
+              eg.release();
+            return result;
+          }
+
+          ctx().stream().unwind(e->end);
+          ctx().set_linenumber(e->linenumber);
+          ctx().set_linestart(e->linestart);
+          ctx().set_state(e->state);
+
+          if(e->success)
+            e->events.replay(builder);
+
+          return e->success;
+        }
+      };
+
       template <typename state_modifier_t, typename base_clause_t>
       class state_scope : public clause
       {
       public:
         using clause::clause;
-        
-        bool parse(document_builder &builder)
+
+        // the modifier consumes nothing, and adds no events
+        static constexpr char_set first_chars = first_set<base_clause_t>::chars;
+        static constexpr bool nullable = first_set<base_clause_t>::nullable;
+        static constexpr bool all_or_nothing = is_all_or_nothing<base_clause_t>::value;
+
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           context_guard cg(ctx());
 
@@ -284,7 +611,8 @@ namespace kyaml
       public:
         using clause::clause;
 
-        bool parse(document_builder &builder)
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           ctx().set_blockflow(blockflow_v);
           return true;
@@ -296,7 +624,8 @@ namespace kyaml
       public:
         using clause::clause;
 
-        bool parse(document_builder &builder)
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           int i = ctx().indent_level();
           ctx().set_indent(++i);
@@ -310,7 +639,8 @@ namespace kyaml
       public:
         using clause::clause;
 
-        bool parse(document_builder &builder)
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           ctx().set_indent(indent_v);
           return true;
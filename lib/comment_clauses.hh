@@ -20,7 +20,8 @@ namespace kyaml
       public:
         using clause::clause;
         
-        bool parse(document_builder &builder)
+        template <typename builder_t>
+        bool parse(builder_t &builder)
         {
           return ctx().stream().eof();
         }
@@ -45,9 +46,11 @@ namespace kyaml
 
     // [79] 	s-l-comments 	::= 	( s-b-comment | Start of line )
     //                                    l-comment* 
-    typedef internal::and_clause<internal::or_clause<sbreak_comment,
-                                                     internal::eating_start_of_line>,
-                                 internal::zero_or_more<line_comment> > sline_comment;
+    // no content, so nothing reaches the builder: the line breaks would otherwise end up in the
+    // event logs of the enclosing clauses and hold back what follows
+    typedef internal::silent<internal::and_clause<internal::or_clause<sbreak_comment,
+                                                                      internal::eating_start_of_line>,
+                                                  internal::zero_or_more<line_comment> > > sline_comment;
   }
 }
 
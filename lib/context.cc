@@ -19,6 +19,7 @@ stream_guard::stream_guard(context &ctx) :
   d_ctx(ctx),
   d_mark(ctx.stream().mark()),
   d_line(ctx.linenumber()),
+  d_linestart(ctx.linestart()),
   d_canceled(false)
 {}
 
@@ -28,6 +29,7 @@ stream_guard::~stream_guard()
   {
     d_ctx.stream().unwind(d_mark);
     d_ctx.set_linenumber(d_line);
+    d_ctx.set_linestart(d_linestart);
   }
 }
 
@@ -6,6 +6,8 @@
 
 namespace kyaml
 {
+  class memo_table;
+
   class context : private no_copy
   {
   public:
@@ -49,7 +51,9 @@ namespace kyaml
             unsigned l = 1) :
       d_stream(str),
       d_state(indent_level, bf, c),
-      d_linenumber(l)
+      d_linenumber(l),
+      d_linestart(0),
+      d_memo(nullptr)
     {}
 
     void reset(int indent_level = -1, blockflow_t bf = NA, chomp_t c = CLIP)
@@ -110,6 +114,24 @@ namespace kyaml
     void newline()
     {
       ++d_linenumber;
+      d_linestart = d_stream.pos();
+    }
+
+    // 1-based column of the read pos
+    unsigned column() const
+    {
+      return d_stream.pos() - d_linestart + 1;
+    }
+
+    // stream pos of the start of the current line, may be negative if that was ignore()d
+    long linestart() const
+    {
+      return d_linestart;
+    }
+
+    void set_linestart(long ls)
+    {
+      d_linestart = ls;
     }
 
     state get_state() const
@@ -122,10 +144,23 @@ namespace kyaml
       d_state = s;
     }
 
+    // optional packrat memoization, nullptr when disabled
+    memo_table *memo() const
+    {
+      return d_memo;
+    }
+
+    void set_memo(memo_table *m)
+    {
+      d_memo = m;
+    }
+
   private:
     char_stream &d_stream;
     state d_state;
     unsigned d_linenumber; // should maybe be part of the stream, not of context
+    long d_linestart;
+    memo_table *d_memo;
   };
 
   // scope-based state guard
@@ -162,6 +197,7 @@ namespace kyaml
     context &d_ctx;
     const char_stream::mark_t d_mark;
     const unsigned d_line;
+    const long d_linestart;
     bool d_canceled;
   };
 
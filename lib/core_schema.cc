@@ -0,0 +1,144 @@
+#include "core_schema.hh"
+#include <charconv>
+#include <limits>
+
+using namespace std;
+
+namespace
+{
+  bool is_digit(char c)
+  {
+    return c >= '0' && c <= '9';
+  }
+
+  // count the leading decimal digits
+  size_t digits(string_view text, size_t from)
+  {
+    size_t n = from;
+    while(n < text.size() && is_digit(text[n]))
+      ++n;
+    return n - from;
+  }
+
+  // all of text as an integer in the given base, without sign
+  bool whole_number(string_view text, int base, int64_t &value)
+  {
+    if(text.empty() || text[0] == '-' || text[0] == '+')
+      return false;
+
+    char const *end = text.data() + text.size();
+    from_chars_result r = from_chars(text.data(), end, value, base);
+    return r.ec == errc() && r.ptr == end;
+  }
+}
+
+bool kyaml::core_null(string_view text)
+{
+  // [10.3.2] null | Null | NULL | ~ | empty
+  return text.empty() || text == "~" || text == "null" || text == "Null" || text == "NULL";
+}
+
+bool kyaml::core_bool(string_view text, bool &value)
+{
+  // [10.3.2] true | True | TRUE | false | False | FALSE
+  if(text == "true" || text == "True" || text == "TRUE")
+    value = true;
+  else if(text == "false" || text == "False" || text == "FALSE")
+    value = false;
+  else
+    return false;
+  return true;
+}
+
+bool kyaml::core_int(string_view text, int64_t &value)
+{
+  // [10.3.2] 0o [0-7]+
+  if(text.size() > 2 && text[0] == '0' && text[1] == 'o')
+    return whole_number(text.substr(2), 8, value);
+
+  // [10.3.2] 0x [0-9a-fA-F]+
+  if(text.size() > 2 && text[0] == '0' && text[1] == 'x')
+    return whole_number(text.substr(2), 16, value);
+
+  // [10.3.2] [-+]? [0-9]+
+  bool negative = !text.empty() && text[0] == '-';
+  if(!text.empty() && (text[0] == '-' || text[0] == '+'))
+    text.remove_prefix(1);
+
+  if(text.empty() || digits(text, 0) != text.size())
+    return false;
+
+  // accumulate negatively so the minimum fits as well
+  int64_t result = 0;
+  for(char c : text)
+  {
+    int d = c - '0';
+    if(result < (numeric_limits<int64_t>::min() + d) / 10)
+      return false;
+    result = result * 10 - d;
+  }
+
+  if(!negative)
+  {
+    if(result == numeric_limits<int64_t>::min())
+      return false;
+    result = -result;
+  }
+  value = result;
+  return true;
+}
+
+bool kyaml::core_float(string_view text, double &value)
+{
+  // [10.3.2] \.nan | \.NaN | \.NAN
+  if(text == ".nan" || text == ".NaN" || text == ".NAN")
+  {
+    value = numeric_limits<double>::quiet_NaN();
+    return true;
+  }
+
+  string_view body = text;
+  bool negative = !body.empty() && body[0] == '-';
+  if(!body.empty() && (body[0] == '-' || body[0] == '+'))
+    body.remove_prefix(1);
+
+  // [10.3.2] [-+]? ( \.inf | \.Inf | \.INF )
+  if(body == ".inf" || body == ".Inf" || body == ".INF")
+  {
+    value = negative ? -numeric_limits<double>::infinity() : numeric_limits<double>::infinity();
+    return true;
+  }
+
+  // [10.3.2] [-+]? ( \. [0-9]+ | [0-9]+ ( \. [0-9]* )? ) ( [eE] [-+]? [0-9]+ )?
+  size_t pos = digits(body, 0);
+  if(pos < body.size() && body[pos] == '.')
+  {
+    size_t fraction = digits(body, pos + 1);
+    if(pos == 0 && fraction == 0)
+      return false;
+    pos += 1 + fraction;
+  }
+  else if(pos == 0)
+    return false;
+
+  if(pos < body.size() && (body[pos] == 'e' || body[pos] == 'E'))
+  {
+    size_t exp = pos + 1;
+    if(exp < body.size() && (body[exp] == '-' || body[exp] == '+'))
+      ++exp;
+    size_t n = digits(body, exp);
+    if(n == 0)
+      return false;
+    pos = exp + n;
+  }
+
+  if(pos != body.size())
+    return false;
+
+  // from_chars takes a '-' but not a '+'
+  if(!negative)
+    text = body;
+  char const *end = text.data() + text.size();
+  from_chars_result r = from_chars(text.data(), end, value);
+  return r.ec == errc() && r.ptr == end;
+}
@@ -0,0 +1,17 @@
+#ifndef CORE_SCHEMA_HH
+#define CORE_SCHEMA_HH
+
+#include <cstdint>
+#include <string_view>
+
+namespace kyaml
+{
+  // the plain scalar forms of the YAML 1.2 core schema. Each returns false if text is not of
+  // that form, or for numbers, does not fit.
+  bool core_null(std::string_view text);
+  bool core_bool(std::string_view text, bool &value);
+  bool core_int(std::string_view text, int64_t &value);
+  bool core_float(std::string_view text, double &value);
+}
+
+#endif // CORE_SCHEMA_HH
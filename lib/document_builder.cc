@@ -5,9 +5,31 @@ using namespace std;
 using namespace kyaml;
 
 document_builder::context::context(kyaml::context const &ctx) :
-  d_linenumber(ctx.linenumber())
+  d_linenumber(ctx.linenumber()),
+  d_column(ctx.column()),
+  d_source(ctx.stream().source())
 {}
 
+void document_builder::add_text(context const &ctx, string_view text)
+{
+  size_t i = 0;
+  while(i < text.size())
+  {
+    size_t n = min(nr_utf8bytes(text[i]), sizeof(char32_t));
+    n = max<size_t>(1, min(n, text.size() - i));
+
+    char32_t c = 0;
+    for(size_t j = 0; j < n; ++j)
+    {
+      c <<= 8;
+      c |= static_cast<uint8_t>(text[i + j]);
+    }
+
+    add_atom(ctx, c);
+    i += n;
+  }
+}
+
 void replay_builder::start_sequence(context const &ctx)
 {
   d_items.emplace_back(START_SEQUENCE, ctx);
@@ -53,38 +75,82 @@ void replay_builder::add_property(context const &ctx, const string &prop)
   d_items.emplace_back(PROPERTY, ctx, prop);
 }
 
-void replay_builder::replay(document_builder &builder) const
+void replay_builder::add_text(context const &ctx, string_view text)
 {
-  for(auto&& it : d_items)
+  if(ctx.in_source(text))
   {
-    switch(it.token)
+    d_items.emplace_back(BORROWED_TEXT, ctx);
+    d_items.back().borrowed = text;
+  }
+  else
+    d_items.emplace_back(TEXT, ctx, text);
+}
+
+void replay_builder::add_borrowed_scalar(context const &ctx, string_view val)
+{
+  d_items.emplace_back(BORROWED_SCALAR, ctx);
+  d_items.back().borrowed = val;
+}
+
+void replay_builder::add_plain_scalar(context const &ctx, string_view val, bool borrowed)
+{
+  if(borrowed)
+  {
+    d_items.emplace_back(BORROWED_PLAIN_SCALAR, ctx);
+    d_items.back().borrowed = val;
+  }
+  else
+    d_items.emplace_back(PLAIN_SCALAR, ctx, val);
+}
+
+void replay_builder::replay(document_builder &builder, size_t from) const
+{
+  assert(from <= d_items.size());
+  for(auto it = d_items.begin() + from; it != d_items.end(); ++it)
+  {
+    switch(it->token)
     {
     case START_SEQUENCE:
-      builder.start_sequence(it.ctx);
+      builder.start_sequence(it->ctx);
       break;
     case END_SEQUENCE:
-      builder.end_sequence(it.ctx);
+      builder.end_sequence(it->ctx);
       break;
     case START_MAPPING:
-      builder.start_mapping(it.ctx);
+      builder.start_mapping(it->ctx);
       break;
     case END_MAPPING:
-      builder.end_mapping(it.ctx);
+      builder.end_mapping(it->ctx);
       break;
     case ANCHOR:
-      builder.add_anchor(it.ctx, it.value);
+      builder.add_anchor(it->ctx, it->value);
       break;
     case ALIAS:
-      builder.add_alias(it.ctx, it.value);
+      builder.add_alias(it->ctx, it->value);
       break;
     case SCALAR:
-      builder.add_scalar(it.ctx, it.value);
+      builder.add_scalar(it->ctx, it->value);
       break;
     case ATOM:
-      builder.add_atom(it.ctx, it.atom);
+      builder.add_atom(it->ctx, it->atom);
       break;
     case PROPERTY:
-      builder.add_property(it.ctx, it.value);
+      builder.add_property(it->ctx, it->value);
+      break;
+    case TEXT:
+      builder.add_text(it->ctx, it->value);
+      break;
+    case BORROWED_TEXT:
+      builder.add_text(it->ctx, it->borrowed);
+      break;
+    case BORROWED_SCALAR:
+      builder.add_borrowed_scalar(it->ctx, it->borrowed);
+      break;
+    case PLAIN_SCALAR:
+      builder.add_plain_scalar(it->ctx, it->value, false);
+      break;
+    case BORROWED_PLAIN_SCALAR:
+      builder.add_plain_scalar(it->ctx, it->borrowed, true);
       break;
     default:
       assert(false);
@@ -2,15 +2,18 @@
 #define DOCUMENT_BUILDER_HH
 
 #include <string>
+#include <string_view>
 #include <ostream>
 #include <memory>
 #include <utils.hh>
 #include <cassert>
 #include <vector>
+#include <type_traits>
 
 namespace kyaml
 {
   class context;
+  class replay_builder;
 
   class document_builder
   {
@@ -26,8 +29,25 @@ namespace kyaml
       {
         return d_linenumber;
       }
+
+      unsigned column() const
+      {
+        return d_column;
+      }
+
+      // true if text lies in the caller-owned input buffer, so it stays valid as long as that
+      // buffer does. Never for input from a std::istream, as those bytes move around.
+      bool in_source(std::string_view text) const
+      {
+        return
+          !text.empty() &&
+          text.data() >= d_source.data() &&
+          text.data() + text.size() <= d_source.data() + d_source.size();
+      }
     private:
       unsigned d_linenumber;
+      unsigned d_column;
+      std::string_view d_source;
     };
 
     virtual ~document_builder()
@@ -43,9 +63,54 @@ namespace kyaml
     virtual void add_scalar(context const &ctx, std::string const &val) = 0;
     virtual void add_atom(context const &ctx, char32_t c) = 0;
     virtual void add_property(context const &ctx, std::string const &prop) = 0;
+
+    // a run of utf8 text, equivalent to an add_atom() per character but much cheaper for
+    // builders that can take it in bulk
+    virtual void add_text(context const &ctx, std::string_view text);
+
+    // a scalar that is an exact range of a caller-owned input buffer, so it stays valid as long
+    // as that buffer does. Builders that don't care can take it as any other scalar.
+    virtual void add_borrowed_scalar(context const &ctx, std::string_view val)
+    {
+      add_scalar(ctx, std::string(val));
+    }
+
+    // an unquoted scalar, which unlike the others may stand for a null, bool or number. If
+    // borrowed, val is a range of the input as for add_borrowed_scalar.
+    virtual void add_plain_scalar(context const &ctx, std::string_view val, bool borrowed)
+    {
+      if(borrowed)
+        add_borrowed_scalar(ctx, val);
+      else
+        add_scalar(ctx, std::string(val));
+    }
+
+    // if this builder is an event log that can be rolled back, return it
+    virtual replay_builder *log()
+    {
+      return nullptr;
+    }
+
+    // true if all events are thrown away, clauses can skip the work of generating them. For the
+    // clauses compiled out of line, which only know their builder as a document_builder. The
+    // clause templates know it at compile time, see discards_v.
+    bool discards() const
+    {
+      return d_discards;
+    }
+
+  protected:
+    document_builder(bool discards = false) :
+      d_discards(discards)
+    {}
+
+  private:
+    bool d_discards;
   };
 
-  class string_builder : public document_builder
+  // collects the text of a scalar. Text runs from the input buffer are kept by reference until
+  // anything else is added.
+  class string_builder final : public document_builder
   {
   public:
     void start_sequence(context const &ctx) override
@@ -71,26 +136,69 @@ namespace kyaml
 
     void add_scalar(context const &ctx, std::string const &val) override
     {
+      materialize();
       d_value += val;
     }
 
     void add_atom(context const &ctx, char32_t c) override
     {
+      materialize();
       append_utf8(d_value, c);
     }
 
-    std::string const &build() const
+    void add_text(context const &ctx, std::string_view text) override
+    {
+      if(d_value.empty() && ctx.in_source(text))
+      {
+        if(d_view.empty())
+        {
+          d_view = text;
+          return;
+        }
+        if(text.data() == d_view.data() + d_view.size()) // adjacent in the input
+        {
+          d_view = std::string_view(d_view.data(), d_view.size() + text.size());
+          return;
+        }
+      }
+
+      materialize();
+      d_value.append(text);
+    }
+
+    std::string const &build()
     {
+      materialize();
       return d_value;
     }
 
+    // the value as a range of the input, if it was taken from it as a whole. Empty otherwise.
+    std::string_view borrowed() const
+    {
+      return d_view;
+    }
+
   private:
+    void materialize()
+    {
+      if(!d_view.empty())
+      {
+        d_value.assign(d_view);
+        d_view = std::string_view();
+      }
+    }
+
+    std::string_view d_view;
     std::string d_value;
   };
 
-  class null_builder : public document_builder
+  class null_builder final : public document_builder
   {
   public:
+    null_builder() :
+      document_builder(true)
+    {}
+
     void start_sequence(context const &ctx) override
     {}
 
@@ -117,9 +225,23 @@ namespace kyaml
 
     void add_atom(context const &ctx, char32_t c) override
     {}
+
+    void add_text(context const &ctx, std::string_view text) override
+    {}
+
+    void add_borrowed_scalar(context const &ctx, std::string_view val) override
+    {}
+
+    void add_plain_scalar(context const &ctx, std::string_view val, bool borrowed) override
+    {}
   };
 
-  class replay_builder : public document_builder
+  // builders that are known to discard everything at compile time. The clause templates are
+  // instantiated for them, with the event calls inlined away and nothing logged.
+  template <typename builder_t>
+  constexpr bool discards_v = std::is_same_v<builder_t, null_builder>;
+
+  class replay_builder final : public document_builder
   {
   public:
 
@@ -133,8 +255,29 @@ namespace kyaml
     void add_scalar(context const &ctx, std::string const &val) override;
     void add_atom(context const &ctx, char32_t c) override;
     void add_property(context const &ctx, std::string const &prop) override;
+    void add_text(context const &ctx, std::string_view text) override;
+    void add_borrowed_scalar(context const &ctx, std::string_view val) override;
+    void add_plain_scalar(context const &ctx, std::string_view val, bool borrowed) override;
+
+    replay_builder *log() override
+    {
+      return this;
+    }
 
-    void replay(document_builder &builder) const;
+    // replay all events starting at index from
+    void replay(document_builder &builder, size_t from = 0) const;
+
+    size_t size() const
+    {
+      return d_items.size();
+    }
+
+    // drop all events from index n onwards
+    void truncate(size_t n)
+    {
+      assert(n <= d_items.size());
+      d_items.erase(d_items.begin() + n, d_items.end());
+    }
 
   private:
     typedef enum
@@ -148,6 +291,11 @@ namespace kyaml
       SCALAR,
       ATOM,
       PROPERTY,
+      TEXT,
+      BORROWED_TEXT,
+      BORROWED_SCALAR,
+      PLAIN_SCALAR,
+      BORROWED_PLAIN_SCALAR,
     } token_t;
 
     struct item
@@ -155,9 +303,10 @@ namespace kyaml
       token_t token;
       context ctx;
       std::string value;
+      std::string_view borrowed; // BORROWED_ tokens refer to the input instead of value
       char32_t atom;
 
-      item(token_t t, context const &c, std::string const &v = "") :
+      item(token_t t, context const &c, std::string_view v = std::string_view()) :
         token(t),
         ctx(c),
         value(v),
@@ -173,6 +322,66 @@ namespace kyaml
 
     std::vector<item> d_items;
   };
+
+  // scope-based rollback point for events. There is one event log per parse: if the target
+  // already is a log the events are appended to it, and rolled back by truncating. Otherwise
+  // this is the outermost commit point, the events are collected in a private log which is
+  // forwarded to the target on release. Targets that discard all events need neither.
+  class event_guard : private no_copy
+  {
+  public:
+    event_guard(document_builder &target) :
+      d_target(target),
+      d_log(target.log()),
+      d_mark(0),
+      d_released(false)
+    {
+      if(d_log)
+        d_mark = d_log->size();
+      else if(!target.discards())
+        d_log = &d_own;
+    }
+
+    ~event_guard()
+    {
+      if(d_log && !d_released)
+        d_log->truncate(d_mark);
+    }
+
+    // where the events should go
+    document_builder &builder()
+    {
+      return d_log ? *d_log : d_target;
+    }
+
+    // where the events should go when nothing after them can be rolled back: straight to the
+    // target, unless that would overtake events that are still held back
+    document_builder &tail_builder()
+    {
+      return d_log == &d_own && d_own.size() == 0 ? d_target : builder();
+    }
+
+    // all events that were added since construction
+    void replay(document_builder &builder) const
+    {
+      if(d_log)
+        d_log->replay(builder, d_mark);
+    }
+
+    void release()
+    {
+      if(d_log == &d_own)
+        d_own.replay(d_target);
+      d_released = true;
+    }
+
+  private:
+    document_builder &d_target;
+    replay_builder *d_log;
+    replay_builder d_own;
+    size_t d_mark;
+    bool d_released;
+  };
 }
 
 #endif // DOCUMENT_BUILDER_HH
@@ -12,8 +12,8 @@ namespace kyaml
   namespace clauses
   {
     // [202] 	l-document-prefix 	::= 	c-byte-order-mark? l-comment* 
-    typedef internal::and_clause<internal::zero_or_one<byte_order_mark>,
-                                 internal::zero_or_more<line_comment> > document_prefix;
+    typedef internal::silent<internal::and_clause<internal::zero_or_one<byte_order_mark>,
+                                                  internal::zero_or_more<line_comment> > > document_prefix;
 
                                                   
     // [203] 	c-directives-end 	::= 	“-” “-” “-” 
@@ -0,0 +1,41 @@
+#ifndef DOCUMENT_STEPPER_HH
+#define DOCUMENT_STEPPER_HH
+
+#include "kyaml.hh"
+#include "block_clauses.hh"
+#include "document_builder.hh"
+#include <memory>
+
+namespace kyaml
+{
+  class skip_guard;
+
+  // parses the next document of a parser a bit at a time, on the caller's thread: a top-level
+  // block collection one entry per step, any other document in a single step. If the document
+  // was not parsed to the end by the time the stepper is gone, the rest of it is skipped.
+  class document_stepper : private no_copy
+  {
+  public:
+    document_stepper(parser &p);
+    ~document_stepper();
+
+    // feed the events of the next part of the document to builder, false if the document was
+    // done already. May throw parser::error.
+    bool step(document_builder &builder);
+
+  private:
+    typedef enum
+    {
+      START,
+      ENTRIES,
+      DONE,
+    } state_t;
+
+    parser_impl &d_parser;
+    std::unique_ptr<skip_guard> d_skip;
+    clauses::block_collection_entries d_entries;
+    state_t d_state;
+  };
+}
+
+#endif // DOCUMENT_STEPPER_HH
@@ -0,0 +1,132 @@
+#include "event_reader.hh"
+#include "kyaml.hh"
+#include "document_stepper.hh"
+#include "handler_builder.hh"
+#include "utils.hh"
+#include <cassert>
+#include <exception>
+#include <vector>
+
+using namespace std;
+using namespace kyaml;
+
+namespace kyaml
+{
+  // the parser is push-based, so the document is parsed one step at a time and the events of
+  // each step are queued until the reader took them. A step is a single entry of a top-level
+  // block collection, or the whole document if it is anything else.
+  class event_reader_impl : private event_handler, private no_copy
+  {
+  public:
+    event_reader_impl(parser &p) :
+      d_stepper(p),
+      d_builder(*this),
+      d_pos(0)
+    {}
+
+    bool next(event &e)
+    {
+      while(d_pos == d_events.size())
+      {
+        d_events.clear();
+        d_pos = 0;
+
+        if(d_error)
+        {
+          exception_ptr error = d_error;
+          d_error = nullptr;
+          rethrow_exception(error);
+        }
+
+        if(!fetch())
+          return false;
+      }
+
+      e = std::move(d_events[d_pos++]);
+      return true;
+    }
+
+  private:
+    // parse the next step, false if the document is done. Events before an error still have
+    // to be delivered, so the error waits until they are.
+    bool fetch()
+    {
+      try
+      {
+        return d_stepper.step(d_builder);
+      }
+      catch(parser::error const &)
+      {
+        if(d_events.empty())
+          throw;
+        d_error = current_exception();
+        return true;
+      }
+    }
+
+    void add(event::type_t type, position const &pos, string const &value = string())
+    {
+      d_events.push_back(event{type, value, pos});
+    }
+
+    void start_sequence(position const &pos) override
+    {
+      add(event::START_SEQUENCE, pos);
+    }
+
+    void end_sequence(position const &pos) override
+    {
+      add(event::END_SEQUENCE, pos);
+    }
+
+    void start_mapping(position const &pos) override
+    {
+      add(event::START_MAPPING, pos);
+    }
+
+    void end_mapping(position const &pos) override
+    {
+      add(event::END_MAPPING, pos);
+    }
+
+    void scalar(position const &pos, string const &value) override
+    {
+      add(event::SCALAR, pos, value);
+    }
+
+    void alias(position const &pos, string const &name) override
+    {
+      add(event::ALIAS, pos, name);
+    }
+
+    void anchor(position const &pos, string const &name) override
+    {
+      add(event::ANCHOR, pos, name);
+    }
+
+    void tag(position const &pos, string const &tag) override
+    {
+      add(event::TAG, pos, tag);
+    }
+
+    document_stepper d_stepper;
+    handler_builder d_builder;
+
+    vector<event> d_events;
+    size_t d_pos;
+    exception_ptr d_error;
+  };
+
+  event_reader::event_reader(parser &p) :
+    d_pimpl(new event_reader_impl(p))
+  {}
+
+  event_reader::~event_reader()
+  {}
+
+  bool event_reader::next(event &e)
+  {
+    assert(d_pimpl);
+    return d_pimpl->next(e);
+  }
+}
@@ -15,7 +15,8 @@ namespace kyaml
     public:
       using clause::clause;
 
-      bool parse(document_builder &builder)
+      template <typename builder_t>
+      bool parse(builder_t &builder)
       {
         return true;
       }
@@ -53,7 +54,7 @@ namespace kyaml
     };
 
     // [156] 	ns-flow-yaml-content(n,c) 	::= 	ns-plain(n,c)
-    typedef plain flow_yaml_content;
+    typedef internal::memoize<plain> flow_yaml_content;
 
     // [157] 	c-flow-json-content(n,c) 	::= 	  c-flow-sequence(n,c) | c-flow-mapping(n,c)
     //                                        | c-single-quoted(n,c) | c-double-quoted(n,c)
@@ -62,6 +63,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "[{\'\"";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
     };
 
@@ -77,15 +81,16 @@ namespace kyaml
     //                                                | e-scalar 
     //                                              ) 
     //                                            )
-    typedef internal::any_of<alias_node,
-                             flow_yaml_content,
-                             internal::and_clause<properties,
-                                                  internal::or_clause<internal::and_clause<separate,
-                                                                                           flow_yaml_content>,
-                                                                      escalar
-                                                                     >
-                                                 >
-                            > flow_yaml_node;    
+    typedef internal::memoize<internal::any_of<alias_node,
+                                               flow_yaml_content,
+                                               internal::and_clause<properties,
+                                                                    internal::or_clause<internal::and_clause<separate,
+                                                                                                             flow_yaml_content>,
+                                                                                        escalar
+                                                                                       >
+                                                                   >
+                                              >
+                             > flow_yaml_node;
     // [160] 	c-flow-json-node(n,c) 	::= 	( c-ns-properties(n,c) s-separate(n,c) )?
     //                                            c-flow-json-content(n,c)
     typedef internal::and_clause<internal::zero_or_one<internal::and_clause<properties,
@@ -101,15 +106,16 @@ namespace kyaml
     //                                                | e-scalar 
     //                                              ) 
     //                                            )
-    typedef internal::any_of<alias_node,
-                             flow_content,
-                             internal::and_clause<properties,
-                                                  internal::or_clause<internal::and_clause<separate,
-                                                                                           flow_content>,
-                                                                      escalar
-                                                                     >
-                                                 >
-                            > flow_node;
+    typedef internal::memoize<internal::any_of<alias_node,
+                                               flow_content,
+                                               internal::and_clause<properties,
+                                                                    internal::or_clause<internal::and_clause<separate,
+                                                                                                             flow_content>,
+                                                                                        escalar
+                                                                                       >
+                                                                   >
+                                              >
+                             > flow_node;
  
     // [149] 	c-ns-flow-map-adjacent-value(n,c) 	::= 	“:” ( ( s-separate(n,c)?
     //                                                                  ns-flow-node(n,c) 
@@ -217,32 +223,43 @@ namespace kyaml
                                                  separate,
                                                  flow_map_explicit_entry>,
                                 flow_pair_entry> flow_pair;
-    // [141] 	ns-s-flow-map-entries(n,c) 	::= 	ns-flow-map-entry(n,c) s-separate(n,c)?
-    //                                                  ( “,” s-separate(n,c)?
-    //                                                    ns-s-flow-map-entries(n,c)? 
-    //                                                  )?
-    class flow_map_entries : public clause
+    // the entries of a flow collection, entry_t separated by ",", with an optional trailing ",".
+    // The grammar defines this recursively, which costs a stack frame and a rollback point
+    // per entry; parsed as a loop instead.
+    template <typename entry_t>
+    class flow_entries : public clause
     {
     public:
       using clause::clause;
-      
-      bool parse(document_builder &builder)
+
+      template <typename builder_t>
+      bool parse(builder_t &builder)
       {
-        i_flow_map_entries fme(ctx());
-        return fme.parse(builder);
+        if(!entry_clause(ctx()).parse(builder))
+          return false;
+
+        while(comma_clause(ctx()).parse(builder) &&
+              entry_clause(ctx()).parse(builder))
+          ;
+
+        return true;
       }
 
     private:
-      typedef internal::all_of<flow_map_entry,
-                               internal::zero_or_one<separate>,
-                               internal::zero_or_one<internal::all_of<internal::simple_char_clause<',', false>,
-                                                                      internal::zero_or_one<separate>,
-                                                                      internal::zero_or_one<flow_map_entries>
-                                                                     >
-                                                    >
-                              > i_flow_map_entries;
+      typedef internal::all_of<entry_t,
+                               internal::zero_or_one<separate>
+                              > entry_clause;
+      typedef internal::all_of<internal::simple_char_clause<',', false>,
+                               internal::zero_or_one<separate>
+                              > comma_clause;
     };
 
+    // [141] 	ns-s-flow-map-entries(n,c) 	::= 	ns-flow-map-entry(n,c) s-separate(n,c)?
+    //                                                  ( “,” s-separate(n,c)?
+    //                                                    ns-s-flow-map-entries(n,c)? 
+    //                                                  )?
+    typedef flow_entries<flow_map_entry> flow_map_entries;
+
     // [140] 	c-flow-mapping(n,c) 	::= 	“{” s-separate(n,c)?
     //                                              ns-s-flow-map-entries(n,in-flow(c))? “}”
     typedef internal::all_of<mapping_start,
@@ -258,26 +275,7 @@ namespace kyaml
     //                                                  ( “,” s-separate(n,c)?
     //                                                    ns-s-flow-seq-entries(n,c)? 
     //                                                  )? 
-    class flow_seq_entries : public clause
-    {
-    public:
-      using clause::clause;
-      
-      bool parse(document_builder &builder)
-      {
-        i_flow_seq_entries fse(ctx());
-        return fse.parse(builder);
-      }
-
-    private:
-      typedef internal::all_of<flow_seq_entry,
-                               internal::zero_or_one<separate>,
-                               internal::zero_or_one<internal::all_of<internal::simple_char_clause<',', false>,
-                                                                      internal::zero_or_one<separate>,
-                                                                      internal::zero_or_one<flow_seq_entries> >
-                                                     >
-                               > i_flow_seq_entries;
-    };
+    typedef flow_entries<flow_seq_entry> flow_seq_entries;
 
     // [137] 	c-flow-sequence(n,c) 	::= 	“[” s-separate(n,c)?
     //                                              ns-s-flow-seq-entries(n,in-flow(c))? “]”
@@ -0,0 +1,73 @@
+#ifndef HANDLER_BUILDER_HH
+#define HANDLER_BUILDER_HH
+
+#include "event_handler.hh"
+#include "document_builder.hh"
+
+namespace kyaml
+{
+  // forwards the structural events to a public event_handler, characters are not of interest
+  class handler_builder final : public document_builder
+  {
+  public:
+    handler_builder(event_handler &handler) :
+      d_handler(handler)
+    {}
+
+    void start_sequence(context const &ctx) override
+    {
+      d_handler.start_sequence(position(ctx));
+    }
+
+    void end_sequence(context const &ctx) override
+    {
+      d_handler.end_sequence(position(ctx));
+    }
+
+    void start_mapping(context const &ctx) override
+    {
+      d_handler.start_mapping(position(ctx));
+    }
+
+    void end_mapping(context const &ctx) override
+    {
+      d_handler.end_mapping(position(ctx));
+    }
+
+    void add_anchor(context const &ctx, std::string const &anchor) override
+    {
+      d_handler.anchor(position(ctx), anchor);
+    }
+
+    void add_alias(context const &ctx, std::string const &alias) override
+    {
+      d_handler.alias(position(ctx), alias);
+    }
+
+    void add_scalar(context const &ctx, std::string const &val) override
+    {
+      d_handler.scalar(position(ctx), val);
+    }
+
+    void add_property(context const &ctx, std::string const &prop) override
+    {
+      d_handler.tag(position(ctx), prop);
+    }
+
+    void add_atom(context const &ctx, char32_t c) override
+    {}
+
+    void add_text(context const &ctx, std::string_view text) override
+    {}
+
+  private:
+    static event_handler::position position(context const &ctx)
+    {
+      return event_handler::position{ctx.linenumber(), ctx.column()};
+    }
+
+    event_handler &d_handler;
+  };
+}
+
+#endif // HANDLER_BUILDER_HH
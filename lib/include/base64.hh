@@ -0,0 +1,27 @@
+#ifndef BASE64_HH
+#define BASE64_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace kyaml
+{
+  // the most bytes decode_base64 can produce from source_size characters
+  inline size_t base64_decoded_size(size_t source_size)
+  {
+    return source_size / 4 * 3;
+  }
+
+  // decode base64 (RFC 4648, with padding) into the buffer at target, which has room for
+  // capacity bytes. Whitespace, as in line-wrapped !!binary scalars, is skipped. Returns false
+  // on any other character that is not base64, on missing padding, or if target is too small.
+  // On success, written is set to the number of bytes decoded.
+  bool decode_base64(std::string_view source, uint8_t *target, size_t capacity, size_t &written);
+
+  // as above, appending to target
+  bool decode_base64(std::string_view source, std::vector<uint8_t> &target);
+}
+
+#endif // BASE64_HH
@@ -0,0 +1,37 @@
+#ifndef EVENT_HANDLER_HH
+#define EVENT_HANDLER_HH
+
+#include <string>
+
+namespace kyaml
+{
+  // receives the structure of a document as a series of events, without building a tree. An
+  // anchor or tag event applies to the node that follows it. Events are delivered as soon as
+  // they are known, so a document that turns out to be invalid may already have produced some.
+  class event_handler
+  {
+  public:
+    // where the parser was when the event was found, 1-based. For scalars that is just past
+    // the scalar.
+    struct position
+    {
+      unsigned line;
+      unsigned column;
+    };
+
+    virtual ~event_handler()
+    {}
+
+    virtual void start_sequence(position const &pos) = 0;
+    virtual void end_sequence(position const &pos) = 0;
+    virtual void start_mapping(position const &pos) = 0;
+    virtual void end_mapping(position const &pos) = 0;
+
+    virtual void scalar(position const &pos, std::string const &value) = 0;
+    virtual void alias(position const &pos, std::string const &name) = 0;
+    virtual void anchor(position const &pos, std::string const &name) = 0;
+    virtual void tag(position const &pos, std::string const &tag) = 0;
+  };
+}
+
+#endif // EVENT_HANDLER_HH
@@ -0,0 +1,55 @@
+#ifndef EVENT_READER_HH
+#define EVENT_READER_HH
+
+#include <memory>
+#include <string>
+#include "event_handler.hh"
+
+namespace kyaml
+{
+  class parser;
+
+  struct event
+  {
+    typedef enum
+    {
+      START_SEQUENCE,
+      END_SEQUENCE,
+      START_MAPPING,
+      END_MAPPING,
+      SCALAR,
+      ALIAS,
+      ANCHOR,
+      TAG,
+    } type_t;
+
+    type_t type;
+    std::string value; // the scalar value, the alias or anchor name, or the tag
+    event_handler::position pos;
+  };
+
+  class event_reader_impl;
+
+  // pull access to the events of the next document of a parser: the caller asks for one event
+  // at a time and the parser only runs as far as needed to provide it. For a document that is a
+  // block sequence or mapping that is up to the end of the current top-level entry, for any
+  // other document the whole document is parsed at once. The parser must outlive the reader,
+  // and should not be used otherwise until the reader is gone.
+  class event_reader
+  {
+  public:
+    event_reader(parser &p);
+
+    // if the document was not read to the end, the rest of it is skipped
+    ~event_reader();
+
+    // get the next event, false if the end of the document was reached. May throw
+    // parser::error, after all events before the error were returned.
+    bool next(event &e);
+
+  private:
+    std::unique_ptr<event_reader_impl> d_pimpl;
+  };
+}
+
+#endif // EVENT_READER_HH
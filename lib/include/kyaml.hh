@@ -3,7 +3,11 @@
 
 #include <memory>
 #include <istream>
+#include <string_view>
+#include <vector>
 #include "node.hh"
+#include "event_handler.hh"
+#include "tape.hh"
 
 namespace kyaml
 {
@@ -37,17 +41,83 @@ namespace kyaml
       content_error(unsigned linenumber, std::string const &msg = "");
     };
 
-    parser(std::istream &input);
+    // tunables, the defaults should be fine for most uses
+    struct options
+    {
+      options() :
+        memoize(false),
+        resolve(false)
+      {}
+
+      bool memoize; // packrat memoization of clause results, less backtracking at the cost of memory
+
+      // resolve scalars by the YAML 1.2 core schema while building, so scalar::as() can read nulls,
+      // bools and numbers without converting them again. See scalar::resolve().
+      bool resolve;
+
+      // if set, parse() and parse_tape() only build the parts of the document matching one of these paths, such
+      // as "metadata.labels" or "spec.containers[*].image", plus the collections leading up to
+      // them. Aliases in the selection can only refer to anchors in the selection.
+      // Sequence entries before a selected index are kept in place as empty scalars with the
+      // scalar::skipped_property tag, so "a[2]" still has index 2 but a has three entries.
+      std::vector<std::string> select;
+    };
+
+    // throws std::invalid_argument on malformed options
+    parser(std::istream &input, options const &opts = options());
+
+    // parse directly from an in-memory buffer, without copying it. The buffer must outlive the parser.
+    parser(std::string_view input, options const &opts = options());
+
+    // parse from a shared buffer. Documents built by parse() keep it alive and their scalars refer
+    // into it where no copy is needed, see scalar::view(). The same goes for from_file().
+    parser(std::shared_ptr<std::string const> input, options const &opts = options());
+
+    parser(parser &&other);
     ~parser();
 
+    // parse from a read-only memory mapping of the file at path. Throws std::system_error if the
+    // file can not be opened or mapped.
+    static parser from_file(std::string const &path, options const &opts = options());
+
     std::unique_ptr<const document> parse(); // may throw
 
+    // parse the next document into a flat tape instead of a tree of nodes. May throw.
+    tape parse_tape();
+
+    // parse the next document, feeding its events to handler instead of building it. May throw.
+    void parse(event_handler &handler);
+
+    // outcome of validate()
+    struct validation
+    {
+      bool valid;
+      unsigned linenumber; // of the error
+      std::string message;
+
+      explicit operator bool() const
+      {
+        return valid;
+      }
+    };
+
+    // check the next document for syntax errors without building anything: no nodes, anchors or
+    // scalar text. Aliases are not resolved, so unknown ones go unnoticed. Does not throw parse errors.
+    validation validate();
+
+    // check all remaining documents, up to the first one with an error
+    validation validate_all();
+
     // intended for testing/debugging/error reporting, returns the next n characters of the stream
     std::string peek(size_t n) const;
 
     unsigned linenumber() const;
 
   private:
+    friend class document_stepper;
+
+    parser(std::unique_ptr<parser_impl> pimpl);
+
     std::unique_ptr<parser_impl> d_pimpl; // trick to encapsulate dependencies
   };
 }
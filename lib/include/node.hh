@@ -4,10 +4,17 @@
 #include <string>
 #include <memory>
 #include <vector>
-#include <unordered_map>
+#include <utility>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <cmath>
+#include <type_traits>
 #include <cassert>
 #include <sstream>
-#include <set>
+#include <string_view>
+#include <atomic>
+#include "numeric.hh"
 
 namespace kyaml
 {
@@ -15,11 +22,125 @@ namespace kyaml
   typedef std::vector<uint8_t> binary_t;
 
   class node_visitor;
+  class node_arena;
+  class node_builder;
 
   class sequence;
   class mapping;
   class scalar;
 
+  // interned tag text. Each distinct tag is stored once per parser, or once for all nodes built by
+  // hand, so tags from the same source are equal if their addresses are. The well-known tags
+  // (scalar::int_property and friends) are interned as themselves everywhere.
+  typedef std::string const *tag_id;
+
+  // the tags of a node. Nodes have at most one tag in practice, so the first is kept inline.
+  class tag_set
+  {
+  public:
+    class const_iterator
+    {
+    public:
+      typedef std::forward_iterator_tag iterator_category;
+      typedef std::string value_type;
+      typedef std::ptrdiff_t difference_type;
+      typedef std::string const *pointer;
+      typedef std::string const &reference;
+
+      const_iterator(tag_set const &s, size_t idx) :
+        d_set(&s),
+        d_idx(idx)
+      {}
+
+      std::string const &operator*() const
+      {
+        return *d_set->at(d_idx);
+      }
+
+      std::string const *operator->() const
+      {
+        return d_set->at(d_idx);
+      }
+
+      const_iterator &operator++()
+      {
+        ++d_idx;
+        return *this;
+      }
+
+      bool operator==(const_iterator const &other) const
+      {
+        return d_idx == other.d_idx;
+      }
+
+      bool operator!=(const_iterator const &other) const
+      {
+        return d_idx != other.d_idx;
+      }
+
+    private:
+      tag_set const *d_set;
+      size_t d_idx;
+    };
+
+    tag_set() :
+      d_first(nullptr)
+    {}
+
+    tag_set(tag_set const &other);
+    tag_set &operator=(tag_set const &other);
+
+    size_t size() const
+    {
+      return d_first ? 1 + (d_more ? d_more->size() : 0) : 0;
+    }
+
+    bool empty() const
+    {
+      return !d_first;
+    }
+
+    tag_id at(size_t idx) const
+    {
+      assert(idx < size());
+      return idx == 0 ? d_first : (*d_more)[idx - 1];
+    }
+
+    // compares addresses only, tag has to be interned by the same table
+    bool contains(tag_id tag) const
+    {
+      return d_first == tag || (d_more && contains_more(tag));
+    }
+
+    // compares addresses first, and the text only if those differ
+    bool contains(std::string_view tag) const;
+
+    // as std::set
+    size_t count(std::string_view tag) const
+    {
+      return contains(tag) ? 1 : 0;
+    }
+
+    // tag has to be interned, adding a tag twice has no effect
+    void insert(tag_id tag);
+
+    const_iterator begin() const
+    {
+      return const_iterator(*this, 0);
+    }
+
+    const_iterator end() const
+    {
+      return const_iterator(*this, size());
+    }
+
+  private:
+    bool contains_more(tag_id tag) const;
+
+    tag_id d_first;
+    std::unique_ptr<std::vector<tag_id> > d_more; // in the rare case of more than one tag
+  };
+
   class node
   {
   public:
@@ -42,24 +163,39 @@ namespace kyaml
       using std::runtime_error::runtime_error;
     };
 
-    typedef std::set<std::string> properties_t;
+    typedef tag_set properties_t;
 
-    virtual ~node()
-    {}
+    node();
+
+    // these copy the node itself only: a copy refers to the same children and tags. A copy of a
+    // node of a parsed document shares ownership of its arena, so it outlives the document.
+    node(node const &other);
+    node(node &&other);
+    node &operator=(node const &other);
+    node &operator=(node &&other);
+
+    virtual ~node();
 
     virtual type_t type() const = 0;
 
     // easy access: get as value, item from sequence, or value from map. may throw
     virtual std::string const &get() const; // throws if type() != SCALAR
 
+    virtual std::string_view view() const; // as get(), without copying borrowed scalars
+
     virtual node const &get(size_t i) const; // throws if type() != SEQUENCE
 
-    virtual node const &get(std::string const &key) const; // throws if type() != MAPPING
+    virtual node const &get(std::string_view key) const; // throws if type() != MAPPING
 
     void add(std::shared_ptr<node> val);
 
     void add(std::string const &key, std::shared_ptr<node> val);
 
+    // add without transferring ownership, val has to outlive this node
+    void add(node const *val);
+
+    void add(std::string const &key, node const *val);
+
     // access child documents. Use integer-types to access items in sequence, strings as keys in mappings
     // will throw on type mismatch.
 
@@ -74,59 +210,51 @@ namespace kyaml
       return get(head).value(std::forward<tail_t>(tail)...);
     }
 
-    // check membership of the item
-    bool has() const // just the sentinel
+    // look up a child document in one pass, nullptr if it is not there. Never throws.
+    node const *find() const // just the sentinel
     {
-      return true;
+      return this;
     }
 
     template <typename... path_t>
-    bool has(size_t idx, path_t&&... path) const
+    node const *find(size_t idx, path_t&&... path) const
     {
-      return
-        type() == SEQUENCE &&
-        has_index(idx) &&
-        get(idx).has(std::forward<path_t>(path)...);
+      node const *child = find_child(idx);
+      return child ? child->find(std::forward<path_t>(path)...) : nullptr;
     }
 
     template <typename... path_t>
-    bool has(std::string const &key, path_t&&... path) const
+    node const *find(std::string_view key, path_t&&... path) const
     {
-      return
-        type() == MAPPING &&
-        has_key(key) &&
-        get(key).has(std::forward<path_t>(path)...);
+      node const *child = find_child(key);
+      return child ? child->find(std::forward<path_t>(path)...) : nullptr;
     }
 
-    // specialized value()/has() for leaf nodes
+    // check membership of the item
     template <typename... path_t>
-    std::string const &leaf_value(path_t&&... path) const
+    bool has(path_t&&... path) const
     {
-      return value(std::forward<path_t>(path)...).get();
+      return find(std::forward<path_t>(path)...) != nullptr;
     }
 
-    // sentinel
-    bool has_leaf() const
+    // specialized value()/has() for leaf nodes
+    template <typename... path_t>
+    std::string const &leaf_value(path_t&&... path) const
     {
-      return type() == SCALAR;
+      return value(std::forward<path_t>(path)...).get();
     }
 
     template <typename... path_t>
-    bool has_leaf(size_t idx, path_t&&... path) const
+    std::string_view leaf_view(path_t&&... path) const
     {
-      return
-        type() == SEQUENCE &&
-        has_index(idx) &&
-        get(idx).has_leaf(std::forward<path_t>(path)...);
+      return value(std::forward<path_t>(path)...).view();
     }
 
     template <typename... path_t>
-    bool has_leaf(std::string const &key, path_t&&... path) const
+    bool has_leaf(path_t&&... path) const
     {
-      return
-        type() == MAPPING &&
-        has_key(key) &&
-        get(key).has_leaf(std::forward<path_t>(path)...);
+      node const *n = find(std::forward<path_t>(path)...);
+      return n && n->type() == SCALAR;
     }
 
     // node properties
@@ -135,12 +263,21 @@ namespace kyaml
       return d_properties;
     }
 
-    bool has_property(std::string const &prop) const
+    bool has_property(std::string_view prop) const
     {
-      return d_properties.find(prop) != d_properties.end();
+      return d_properties.contains(prop);
     }
 
-    void add_property(std::string const &prop)
+    // a plain address compare, for tags interned by the same parser or the well-known ones
+    bool has_property(tag_id prop) const
+    {
+      return d_properties.contains(prop);
+    }
+
+    // prop is interned in a table shared by all nodes built by hand
+    void add_property(std::string const &prop);
+
+    void add_property(tag_id prop)
     {
       d_properties.insert(prop);
     }
@@ -154,28 +291,36 @@ namespace kyaml
     virtual void accept(node_visitor &visitor) const = 0;
 
   protected:
-    virtual bool has_index(size_t idx) const
+    // the direct child, nullptr if there is none or on type mismatch
+    virtual node const *find_child(size_t idx) const
     {
-      return false;
+      return nullptr;
     }
 
-    virtual bool has_key(std::string const &key) const
+    virtual node const *find_child(std::string_view key) const
     {
-      return false;
+      return nullptr;
     }
 
   private:
+    friend class node_builder;
+    friend class node_arena;
+
+    std::shared_ptr<node_arena> owner() const; // the arena keeping this node alive, if any
+
     properties_t d_properties;
+    std::shared_ptr<node_arena> d_arena; // set on the root of a parsed document and on copies of its nodes
+    node_arena *d_home;                  // the arena this node lives in, if any
   };
 
   typedef node document;
 
   // type conversion for scalars.
-  // by default, std::operator<< is used
+  // numbers are converted by parse_number(), anything else by default uses std::operator>>
   // specialized overloads are provided for bool and std::vector<uint8_t> (base64 binary)
   // you can also define your own.
   template <typename target_t>
-  target_t type_convert(node::properties_t const &props, std::string const &input);
+  target_t type_convert(node::properties_t const &props, std::string_view input);
 
   class scalar final : public node
   {
@@ -187,47 +332,169 @@ namespace kyaml
     static const std::string float_property;  // !!float
     static const std::string string_property; // !!str
     static const std::string binary_property; // !!binary
+    static const std::string skipped_property; // !kyaml/skipped, see parser::options::select
+
+    // what the value is by the core schema, if resolved
+    typedef enum
+    {
+      UNRESOLVED,
+      NULL_VALUE,
+      BOOL,
+      INT,
+      FLOAT,
+      STRING
+    } resolved_t;
 
     scalar(std::string const &v) :
-      d_value(v)
+      d_value(v),
+      d_copied(NOT_COPIED),
+      d_borrowed(false),
+      d_resolved(UNRESOLVED)
     {}
 
+    // refers to v instead of copying it, v has to outlive the scalar
+    struct borrowed_t
+    {};
+
+    scalar(borrowed_t, std::string_view v) :
+      d_view(v),
+      d_copied(NOT_COPIED),
+      d_borrowed(true),
+      d_resolved(UNRESOLVED)
+    {}
+
+    // a copy owns its value, also if the original was borrowed
+    scalar(scalar const &other);
+    scalar(scalar &&other);
+    scalar &operator=(scalar const &other);
+    scalar &operator=(scalar &&other);
+
     type_t type() const override
     {
       return SCALAR;
     }
 
+    // a borrowed value is copied into a string the first time it is asked for this way, and so
+    // by leaf_value(). Use view() to read it without copying.
     std::string const &get() const override
     {
+      if(d_borrowed && d_copied.load(std::memory_order_acquire) != COPIED)
+        copy_borrowed();
       return d_value;
     }
 
+    // the value without any copying, for borrowed scalars this refers to the input
+    std::string_view view() const override
+    {
+      return d_borrowed ? d_view : std::string_view(d_value);
+    }
+
+    bool borrowed() const
+    {
+      return d_borrowed;
+    }
+
     template <typename T>
     T get() const
     {
       T t = T();
-      std::stringstream str(d_value);
+      std::stringstream str{std::string(view())};
       str >> t;
       return t;
     }
 
-    // access the value as a specific type
+    // access the value as a specific type. Resolved numbers and bools are taken as they are,
+    // anything else goes through type_convert.
     template <typename target_t>
     target_t as() const
     {
-      return type_convert<target_t>(properties(), d_value);
+      if constexpr(std::is_arithmetic<target_t>::value)
+      {
+        target_t result;
+        if(from_resolved(result))
+          return result;
+      }
+      return type_convert<target_t>(properties(), view());
+    }
+
+    // resolve the value by the YAML 1.2 core schema: by its tag if it has a well-known one, as a
+    // string if it has another tag or is not plain. Done by the parser if asked for.
+    void resolve(bool plain);
+
+    resolved_t resolved() const
+    {
+      return d_resolved;
     }
 
     void accept(node_visitor &visitor) const override;
 
   private:
-    std::string d_value;
+    typedef enum
+    {
+      NOT_COPIED,
+      COPYING,
+      COPIED
+    } copied_t;
+
+    void copy_borrowed() const;
+    void assign(scalar const &other);
+
+    template <typename target_t>
+    bool from_resolved(target_t &target) const
+    {
+      if constexpr(std::is_same<target_t, bool>::value)
+      {
+        if(d_resolved == BOOL || d_resolved == INT)
+        {
+          target = d_resolved == BOOL ? d_bool : d_int != 0;
+          return true;
+        }
+      }
+      else if constexpr(std::is_integral<target_t>::value && sizeof(target_t) > 1) // not as chars
+      {
+        if(d_resolved == INT && fits<target_t>(d_int))
+        {
+          target = static_cast<target_t>(d_int);
+          return true;
+        }
+      }
+      else if constexpr(std::is_floating_point<target_t>::value)
+      {
+        if(d_resolved == FLOAT || d_resolved == INT)
+        {
+          target = d_resolved == FLOAT ? static_cast<target_t>(d_float) : static_cast<target_t>(d_int);
+          return true;
+        }
+      }
+      return false;
+    }
+
+    template <typename target_t>
+    static bool fits(int64_t v)
+    {
+      if constexpr(std::is_unsigned<target_t>::value)
+        return v >= 0 && static_cast<uint64_t>(v) <= std::numeric_limits<target_t>::max();
+      else
+        return v >= std::numeric_limits<target_t>::min() && v <= std::numeric_limits<target_t>::max();
+    }
+
+    mutable std::string d_value;
+    std::string_view d_view;
+    mutable std::atomic<copied_t> d_copied; // borrowed only: whether d_value holds the copy
+    bool d_borrowed;
+    resolved_t d_resolved;
+    union
+    {
+      bool d_bool;
+      int64_t d_int;
+      double d_float;
+    };
   };
 
   class sequence final : public node
   {
   public:
-    typedef std::vector<std::shared_ptr<const node> > container_t;
+    typedef std::vector<node const *> container_t;
 
     type_t type() const override
     {
@@ -258,6 +525,12 @@ namespace kyaml
     }
 
     void add(std::shared_ptr<const node> child)
+    {
+      d_owned.push_back(child);
+      d_items.push_back(child.get());
+    }
+
+    void add(node const *child)
     {
       d_items.push_back(child);
     }
@@ -265,32 +538,35 @@ namespace kyaml
     void accept(node_visitor &visitor) const override;
 
   protected:
-    bool has_index(size_t idx) const override
+    node const *find_child(size_t idx) const override
     {
-      return idx < size();
+      return idx < size() ? d_items[idx] : nullptr;
     }
 
   private:
     container_t d_items;
+    std::vector<std::shared_ptr<const node> > d_owned; // for items not owned by an arena
   };
 
+  // entries are kept in the order they were added. Small mappings are searched linearly, larger
+  // ones get an open-addressing index over the entries.
   class mapping final : public node
   {
   public:
-    typedef std::unordered_map<std::string, std::shared_ptr<const node> > container_t;
+    typedef std::vector<std::pair<std::string, node const *> > container_t;
 
     type_t type() const override
     {
       return MAPPING;
     }
 
-    node const &operator[](std::string const &key) const;
+    node const &operator[](std::string_view key) const;
 
-    node const &get(std::string const &key) const override;
+    node const &get(std::string_view key) const override;
 
-    bool has_key(std::string const &key) const override
+    bool has_key(std::string_view key) const
     {
-      return d_items.find(key) != d_items.end();
+      return find_index(key) != npos;
     }
 
     container_t::const_iterator begin() const
@@ -308,37 +584,112 @@ namespace kyaml
       return d_items.size();
     }
 
+    // keys that are already there are ignored, the first one wins
     void add(std::string const &key, std::shared_ptr<const node> value)
     {
-      d_items.insert(std::make_pair(key, value));
+      if(insert(key, value.get()))
+        d_owned.push_back(value);
+    }
+
+    void add(std::string const &key, node const *value)
+    {
+      insert(key, value);
     }
 
     void accept(node_visitor &visitor) const override;
 
+  protected:
+    node const *find_child(std::string_view key) const override
+    {
+      size_t idx = find_index(key);
+      return idx != npos ? d_items[idx].second : nullptr;
+    }
+
   private:
+    static const size_t npos = size_t(-1);
+    static const size_t s_linear_max = 8; // up to this many entries there is no index
+
+    size_t find_index(std::string_view key) const;
+    bool insert(std::string const &key, node const *value);
+    void index(size_t entry);
+    void rebuild_index();
+
     container_t d_items;
+    std::vector<uint32_t> d_index; // entry + 1 per slot, 0 for empty. Power of two sized, at most half full
+    std::vector<std::shared_ptr<const node> > d_owned; // for items not owned by an arena
   };
 
+  namespace conversion
+  {
+    [[noreturn]] void throw_out_of_range(std::string_view input);
+
+    // integers that are written as floats are truncated, as operator>> would
+    template <typename target_t>
+    target_t convert_integer(std::string_view input)
+    {
+      typedef typename std::conditional<std::is_signed<target_t>::value, int64_t, uint64_t>::type wide_t;
+
+      wide_t wide;
+      number_result_t r = parse_number(input, wide);
+      if(r == NUMBER_INVALID)
+      {
+        long double f;
+        r = parse_number(input, f);
+        if(r == NUMBER_INVALID || (r == NUMBER_OK && std::isnan(f)))
+          return target_t();
+        if(r == NUMBER_OK &&
+           f > static_cast<long double>(std::numeric_limits<target_t>::min()) - 1 &&
+           f < static_cast<long double>(std::numeric_limits<target_t>::max()) + 1)
+          return static_cast<target_t>(f);
+        r = NUMBER_OUT_OF_RANGE;
+      }
+
+      if(r == NUMBER_OUT_OF_RANGE ||
+         wide < static_cast<wide_t>(std::numeric_limits<target_t>::min()) ||
+         wide > static_cast<wide_t>(std::numeric_limits<target_t>::max()))
+        throw_out_of_range(input);
+      return static_cast<target_t>(wide);
+    }
+
+    template <typename target_t>
+    target_t convert_float(std::string_view input)
+    {
+      target_t result = target_t();
+      if(parse_number(input, result) == NUMBER_OUT_OF_RANGE)
+        throw_out_of_range(input);
+      return result;
+    }
+  }
+
+  // numbers that are not a number in any form give 0, numbers that don't fit in target_t throw
+  // node::value_error
   template <typename target_t>
-  target_t type_convert(node::properties_t const &props, std::string const &input)
+  target_t type_convert(node::properties_t const &props, std::string_view input)
   {
-    target_t result = target_t();
-    std::stringstream str(input);
-    str >> result;
-    return result;
+    if constexpr(std::is_integral<target_t>::value && sizeof(target_t) > 1) // chars are read as characters
+      return conversion::convert_integer<target_t>(input);
+    else if constexpr(std::is_floating_point<target_t>::value)
+      return conversion::convert_float<target_t>(input);
+    else
+    {
+      target_t result = target_t();
+      std::stringstream str{std::string(input)};
+      str >> result;
+      return result;
+    }
   }
 
   template<> // overload for bool
-  bool type_convert(node::properties_t const &props, std::string const &input);
+  bool type_convert(node::properties_t const &props, std::string_view input);
 
   template<> // overload for string
-  inline std::string type_convert(node::properties_t const &props, std::string const &input)
+  inline std::string type_convert(node::properties_t const &props, std::string_view input)
   {
-    return input;
+    return std::string(input);
   }
 
   template<> // overload for (base64) binary data
-  binary_t type_convert(node::properties_t const &props, std::string const &input);
+  binary_t type_convert(node::properties_t const &props, std::string_view input);
 }
 
 namespace std
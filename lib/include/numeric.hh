@@ -0,0 +1,27 @@
+#ifndef NUMERIC_HH
+#define NUMERIC_HH
+
+#include <cstdint>
+#include <string_view>
+
+namespace kyaml
+{
+  typedef enum
+  {
+    NUMBER_OK,
+    NUMBER_INVALID,      // none of the forms below
+    NUMBER_OUT_OF_RANGE, // a number, but it does not fit
+  } number_result_t;
+
+  // locale-independent conversion of the numeric forms YAML uses: an optional sign, then
+  // decimal, 0x hex, 0o octal or 0b binary digits, which may be separated by '_'. Floats also
+  // take fractions and exponents, and .inf and .nan in any of the YAML spellings. Surrounding
+  // whitespace is ignored. value is only set on NUMBER_OK.
+  number_result_t parse_number(std::string_view text, int64_t &value);
+  number_result_t parse_number(std::string_view text, uint64_t &value);
+  number_result_t parse_number(std::string_view text, float &value);
+  number_result_t parse_number(std::string_view text, double &value);
+  number_result_t parse_number(std::string_view text, long double &value);
+}
+
+#endif // NUMERIC_HH
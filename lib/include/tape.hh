@@ -0,0 +1,200 @@
+#ifndef TAPE_HH
+#define TAPE_HH
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "node.hh"
+
+namespace kyaml
+{
+  class tape_builder;
+
+  // a parsed document as one flat array of 64-bit entries, with all scalar and tag text in a
+  // single string buffer. Each entry has its type in the top byte and a payload in the rest:
+  //   START_SEQUENCE, START_MAPPING: the index just past the matching end, to skip the subtree
+  //   END_SEQUENCE, END_MAPPING:     the index of the matching start
+  //   SCALAR, TAG:                   the offset of the text, the next entry holds its length
+  //   ALIAS:                         the index of the anchored node
+  // Tags come right before the node they belong to. A tape is a plain value, cheap to move or
+  // copy, and looking up a child is a walk over its preceding siblings.
+  class tape
+  {
+  public:
+    typedef enum
+    {
+      START_SEQUENCE = 1,
+      END_SEQUENCE,
+      START_MAPPING,
+      END_MAPPING,
+      SCALAR,
+      ALIAS,
+      TAG,
+    } entry_t;
+
+    static entry_t type(uint64_t entry)
+    {
+      return static_cast<entry_t>(entry >> 56);
+    }
+
+    static uint64_t payload(uint64_t entry)
+    {
+      return entry & ((uint64_t(1) << 56) - 1);
+    }
+
+    class iterator;
+
+    // a node on the tape, aliases are resolved to the node they refer to
+    class item
+    {
+    public:
+      item(tape const &t, size_t index);
+
+      node::type_t type() const;
+
+      // as in node, these throw node::type_error or node::value_error
+      std::string_view get() const;
+      item get(size_t idx) const;
+      item get(std::string_view key) const;
+
+      // number of items in a sequence or pairs in a mapping
+      size_t size() const;
+
+      std::vector<std::string_view> properties() const;
+      bool has_property(std::string_view prop) const;
+
+      item value() const
+      {
+        return *this;
+      }
+
+      template <typename head_t, typename... tail_t>
+      item value(head_t const &head, tail_t&&... tail) const
+      {
+        return get(head).value(std::forward<tail_t>(tail)...);
+      }
+
+      template <typename... path_t>
+      std::string_view leaf_value(path_t&&... path) const
+      {
+        return value(std::forward<path_t>(path)...).get();
+      }
+
+      bool has() const
+      {
+        return true;
+      }
+
+      template <typename... path_t>
+      bool has(size_t idx, path_t&&... path) const
+      {
+        size_t found;
+        return
+          type() == node::SEQUENCE &&
+          find(idx, found) &&
+          item(*d_tape, found).has(std::forward<path_t>(path)...);
+      }
+
+      template <typename... path_t>
+      bool has(std::string_view key, path_t&&... path) const
+      {
+        size_t found;
+        return
+          type() == node::MAPPING &&
+          find(key, found) &&
+          item(*d_tape, found).has(std::forward<path_t>(path)...);
+      }
+
+      // the children of a collection, for mappings keys and values alternate
+      iterator begin() const;
+      iterator end() const;
+
+      // where this item starts on the tape, including its tags
+      size_t index() const
+      {
+        return d_index;
+      }
+
+    private:
+      bool find(size_t idx, size_t &found) const;
+      bool find(std::string_view key, size_t &found) const;
+
+      tape const *d_tape;
+      size_t d_index; // first entry, including tags
+      size_t d_body;  // the entry after the tags
+    };
+
+    class iterator
+    {
+    public:
+      iterator(tape const &t, size_t index) :
+        d_tape(&t),
+        d_index(index)
+      {}
+
+      item operator*() const
+      {
+        return item(*d_tape, d_index);
+      }
+
+      iterator &operator++()
+      {
+        d_index = d_tape->skip(d_index);
+        return *this;
+      }
+
+      bool operator==(iterator const &other) const
+      {
+        return d_index == other.d_index;
+      }
+
+      bool operator!=(iterator const &other) const
+      {
+        return d_index != other.d_index;
+      }
+
+      // the position on the tape, before resolving aliases
+      size_t index() const
+      {
+        return d_index;
+      }
+
+    private:
+      tape const *d_tape;
+      size_t d_index;
+    };
+
+    // the document, an empty scalar if there was none. Not for default constructed tapes.
+    item root() const
+    {
+      return item(*this, 0);
+    }
+
+    std::vector<uint64_t> const &entries() const
+    {
+      return d_entries;
+    }
+
+    std::string const &strings() const
+    {
+      return d_strings;
+    }
+
+    // the index just past the node starting at index, without resolving aliases
+    size_t skip(size_t index) const;
+
+    std::string_view text(size_t index) const
+    {
+      return std::string_view(d_strings).substr(payload(d_entries[index]), d_entries[index + 1]);
+    }
+
+  private:
+    friend class tape_builder;
+
+    std::vector<uint64_t> d_entries;
+    std::string d_strings;
+  };
+}
+
+#endif // TAPE_HH
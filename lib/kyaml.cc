@@ -1,6 +1,12 @@
 #include "kyaml.hh"
 #include "clauses.hh"
+#include "document_stepper.hh"
 #include "node_builder.hh"
+#include "handler_builder.hh"
+#include "path_filter.hh"
+#include "tape_builder.hh"
+#include "mapped_file.hh"
+#include "memo_table.hh"
 
 using namespace std;
 using namespace kyaml;
@@ -50,6 +56,13 @@ namespace kyaml
     {
       d_ctx.reset();
       skip_till_next();
+
+      // no marks survive a document, so this is the natural point to compact the buffer
+      const long pos = d_ctx.stream().pos();
+      d_ctx.stream().ignore();
+      d_ctx.set_linestart(d_ctx.linestart() - pos);
+      if(d_ctx.memo())
+        d_ctx.memo()->clear();
     }
 
   private:
@@ -93,36 +106,72 @@ namespace kyaml
   class parser_impl
   {
   public:
-    parser_impl(istream &input) :
+    parser_impl(istream &input, parser::options const &opts) :
       d_stream(input),
       d_ctx(d_stream, -1, context::NA)
-    {}
+    {
+      configure(opts);
+    }
 
-    unique_ptr<const document> parse()
+    parser_impl(string_view input, parser::options const &opts) :
+      d_stream(input),
+      d_ctx(d_stream, -1, context::NA)
     {
-      g_log("start parsing at line", d_ctx.linenumber(), peek(20));
+      configure(opts);
+    }
 
-      skip_guard sg(d_ctx);
+    parser_impl(shared_ptr<void const> source, string_view input, parser::options const &opts) :
+      d_source(std::move(source)),
+      d_stream(input),
+      d_ctx(d_stream, -1, context::NA)
+    {
+      configure(opts);
+    }
 
+    unique_ptr<const document> parse()
+    {
       node_builder nb;
+      nb.share_tags(d_tags);
+      nb.resolve_scalars(d_resolve);
+      if(d_source)
+        nb.borrow(d_source);
+      parse_selected(nb);
+      return nb.build();
+    }
 
-      yaml_single_document ys(d_ctx);
+    tape parse_tape()
+    {
+      tape_builder tb;
+      parse_selected(tb);
+      return tb.build();
+    }
 
-      bool r = ys.parse(nb);
-      g_log("done parsing at line", d_ctx.linenumber(), "result", (r ? "good" : "bad"), "head at", peek(20));
+    void parse(event_handler &handler)
+    {
+      handler_builder hb(handler);
+      parse(hb);
+    }
 
-      if(!is_document_end(d_ctx))
+    parser::validation validate()
+    {
+      try
       {
-        g_log("not at document end, reporting error");
-        parse_error(string("parsing stopped before the end of document, could not parse \"") + peek(20) + "\"");
+        null_builder nb;
+        parse(nb);
       }
+      catch(parser::parse_error const &e)
+      {
+        return parser::validation{false, e.linenumber(), e.what()};
+      }
+      return parser::validation{true, 0, ""};
+    }
 
-      if(r)
-        return nb.build();
-
-      parse_error("Could not construct a valid document.");
-
-      return unique_ptr<const document>();
+    parser::validation validate_all()
+    {
+      parser::validation result = validate();
+      while(result && d_ctx.stream().good())
+        result = validate();
+      return result;
     }
 
     string peek(size_t n) const
@@ -153,7 +202,107 @@ namespace kyaml
       return d_ctx.linenumber();
     }
 
+    context &ctx()
+    {
+      return d_ctx;
+    }
+
+    // parse one document into builder without skipping what is left of it after an error,
+    // throws if it is not valid
+    void parse_document(document_builder &builder)
+    {
+      g_log("start parsing at line", d_ctx.linenumber(), peek(20));
+
+      yaml_single_document ys(d_ctx);
+      end_document(ys.parse(builder));
+    }
+
+    // yaml_single_document up to a top-level block collection, and the first entry of that
+    // collection. Nothing is consumed if the document is anything else.
+    bool start_entries(block_collection_entries &entries, document_builder &builder)
+    {
+      typedef internal::all_of<internal::zero_or_more<document_prefix>,
+                               internal::zero_or_one<internal::and_clause<internal::zero_or_more<ldirective>,
+                                                                          directives_end> >,
+                               sline_comment,
+                               internal::not_clause<forbidden>,
+                               internal::indent_modifier<-1>,
+                               internal::flow_modifier<context::BLOCK_IN>
+                              > head_t;
+
+      g_log("start parsing entries at line", d_ctx.linenumber(), peek(20));
+
+      context_guard cg(d_ctx);
+      event_guard eg(builder);
+
+      head_t head(d_ctx);
+      if(head.parse(eg.builder()) && entries.start(eg.builder()))
+      {
+        eg.release();
+        cg.release();
+        return true;
+      }
+      return false;
+    }
+
+    // the rest of the document after the last entry of start_entries()
+    void end_entries(document_builder &builder)
+    {
+      d_ctx.reset();
+
+      internal::zero_or_more<document_suffix> suffix(d_ctx);
+      end_document(suffix.parse(builder));
+    }
+
   private:
+    // parse one document into builder, throws if it is not valid
+    void parse(document_builder &builder)
+    {
+      skip_guard sg(d_ctx);
+      parse_document(builder);
+    }
+
+    void end_document(bool r)
+    {
+      g_log("done parsing at line", d_ctx.linenumber(), "result", (r ? "good" : "bad"), "head at", peek(20));
+
+      if(!is_document_end(d_ctx))
+      {
+        g_log("not at document end, reporting error");
+        parse_error(string("parsing stopped before the end of document, could not parse \"") + peek(20) + "\"");
+      }
+
+      if(!r)
+        parse_error("Could not construct a valid document.");
+    }
+
+    // parse one document into a DOM builder, only passing the selected paths if asked to
+    void parse_selected(document_builder &builder)
+    {
+      if(d_select.empty())
+        parse(builder);
+      else
+      {
+        path_filter pf(d_select, builder);
+        parse(pf);
+      }
+    }
+
+    void configure(parser::options const &opts)
+    {
+      d_tags.reset(new tag_table);
+      d_resolve = opts.resolve;
+
+      for(string const &path : opts.select)
+        d_select.emplace_back(path);
+
+      if(opts.memoize)
+      {
+        d_memo.reset(new memo_table);
+        d_ctx.set_memo(d_memo.get());
+      }
+    }
+
     void parse_error(std::string const &msg = "")
     {
       stringstream stream;
@@ -163,23 +312,73 @@ namespace kyaml
       throw parser::parse_error(linenumber(), stream.str());
     }
 
+    shared_ptr<void const> d_source; // the buffer, if documents may refer to it. Must outlive d_stream
     char_stream d_stream;
     context d_ctx;
+    unique_ptr<memo_table> d_memo;
+    vector<path_pattern> d_select;
+    shared_ptr<tag_table> d_tags; // shared by all documents from this parser
+    bool d_resolve;
   };
 
-  parser::parser(istream &input) :
-    d_pimpl(new parser_impl(input)) // parser_impl ctor can not throw
+  parser::parser(istream &input, options const &opts) :
+    d_pimpl(new parser_impl(input, opts))
+  {}
+
+  parser::parser(string_view input, options const &opts) :
+    d_pimpl(new parser_impl(input, opts))
   {}
 
+  parser::parser(shared_ptr<string const> input, options const &opts) :
+    d_pimpl(new parser_impl(input, *input, opts))
+  {}
+
+  parser::parser(unique_ptr<parser_impl> pimpl) :
+    d_pimpl(std::move(pimpl))
+  {}
+
+  parser::parser(parser &&other) = default;
+
   parser::~parser()
   {}
 
+  parser parser::from_file(string const &path, options const &opts)
+  {
+    shared_ptr<mapped_file> file(new mapped_file(path)); // may throw
+    string_view data = file->data();
+    return parser(unique_ptr<parser_impl>(new parser_impl(std::move(file), data, opts)));
+  }
+
   std::unique_ptr<const document> parser::parse()
   {
     assert(d_pimpl);
     return d_pimpl->parse();
   }
 
+  tape parser::parse_tape()
+  {
+    assert(d_pimpl);
+    return d_pimpl->parse_tape();
+  }
+
+  void parser::parse(event_handler &handler)
+  {
+    assert(d_pimpl);
+    d_pimpl->parse(handler);
+  }
+
+  parser::validation parser::validate()
+  {
+    assert(d_pimpl);
+    return d_pimpl->validate();
+  }
+
+  parser::validation parser::validate_all()
+  {
+    assert(d_pimpl);
+    return d_pimpl->validate_all();
+  }
+
   string parser::peek(size_t n) const
   {
     assert(d_pimpl);
@@ -204,4 +403,39 @@ namespace kyaml
   parser::content_error::content_error(unsigned linenumber, const string &msg) :
     error(linenumber, msg)
   {}
+
+  document_stepper::document_stepper(parser &p) :
+    d_parser(*p.d_pimpl),
+    d_skip(new skip_guard(d_parser.ctx())),
+    d_entries(d_parser.ctx()),
+    d_state(START)
+  {}
+
+  document_stepper::~document_stepper()
+  {}
+
+  bool document_stepper::step(document_builder &builder)
+  {
+    switch(d_state)
+    {
+    case START:
+      d_state = DONE;
+      if(d_parser.start_entries(d_entries, builder))
+        d_state = ENTRIES;
+      else
+        d_parser.parse_document(builder);
+      return true;
+
+    case ENTRIES:
+      if(!d_entries.next(builder))
+      {
+        d_state = DONE;
+        d_parser.end_entries(builder);
+      }
+      return true;
+
+    default:
+      return false;
+    }
+  }
 }
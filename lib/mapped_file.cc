@@ -0,0 +1,68 @@
+#include "mapped_file.hh"
+#include <system_error>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+using namespace kyaml;
+
+namespace
+{
+  void throw_system_error(string const &what, string const &path)
+  {
+    throw system_error(errno, generic_category(), what + " " + path);
+  }
+
+  // closes the descriptor when going out of scope, the mapping stays valid
+  class fd_guard : private no_copy
+  {
+  public:
+    fd_guard(int fd) :
+      d_fd(fd)
+    {}
+
+    ~fd_guard()
+    {
+      close(d_fd);
+    }
+
+  private:
+    int d_fd;
+  };
+}
+
+mapped_file::mapped_file(string const &path) :
+  d_data(nullptr),
+  d_size(0)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0)
+    throw_system_error("could not open", path);
+
+  fd_guard fg(fd);
+
+  struct stat st;
+  if(fstat(fd, &st) != 0)
+    throw_system_error("could not stat", path);
+
+  if(st.st_size == 0) // mmap does not do empty mappings
+    return;
+
+  void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if(data == MAP_FAILED)
+    throw_system_error("could not map", path);
+
+  madvise(data, st.st_size, MADV_SEQUENTIAL); // only a hint, failure is harmless
+
+  d_data = data;
+  d_size = st.st_size;
+}
+
+mapped_file::~mapped_file()
+{
+  if(d_data)
+    munmap(d_data, d_size);
+}
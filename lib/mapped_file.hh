@@ -0,0 +1,28 @@
+#ifndef MAPPED_FILE_HH
+#define MAPPED_FILE_HH
+
+#include <string>
+#include <string_view>
+#include "utils.hh"
+
+namespace kyaml
+{
+  // read-only memory mapping of a complete file, advised for sequential access
+  class mapped_file : private no_copy
+  {
+  public:
+    mapped_file(std::string const &path); // throws std::system_error
+    ~mapped_file();
+
+    std::string_view data() const
+    {
+      return std::string_view(static_cast<char const *>(d_data), d_size);
+    }
+
+  private:
+    void  *d_data;
+    size_t d_size;
+  };
+}
+
+#endif // MAPPED_FILE_HH
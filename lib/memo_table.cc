@@ -0,0 +1,26 @@
+#include "memo_table.hh"
+#include <functional>
+
+using namespace std;
+using namespace kyaml;
+
+size_t memo_table::key_hash::operator()(key const &k) const
+{
+  size_t h = hash<clause_id_t>()(k.clause);
+  h = h * 31 + hash<char_stream::mark_t>()(k.pos);
+  h = h * 31 + static_cast<size_t>(k.indent_level);
+  h = h * 31 + static_cast<size_t>(k.blockflow);
+  h = h * 31 + static_cast<size_t>(k.chomp);
+  return h;
+}
+
+memo_table::entry const *memo_table::find(clause_id_t clause, char_stream::mark_t pos, context::state const &s) const
+{
+  auto it = d_entries.find(key(clause, pos, s));
+  return it == d_entries.end() ? nullptr : &it->second;
+}
+
+memo_table::entry const &memo_table::insert(clause_id_t clause, char_stream::mark_t pos, context::state const &s, entry &&e)
+{
+  return d_entries.insert(make_pair(key(clause, pos, s), std::move(e))).first->second;
+}
@@ -0,0 +1,95 @@
+#ifndef MEMO_TABLE_HH
+#define MEMO_TABLE_HH
+
+#include <unordered_map>
+#include "context.hh"
+#include "document_builder.hh"
+
+namespace kyaml
+{
+  // packrat memoization: remembers the outcome of a clause type parsed at a certain stream
+  // position in a certain state, so it has to be parsed at most once. Entries are only valid
+  // as long as the stream marks are, so clear() on ignore().
+  class memo_table : private no_copy
+  {
+  public:
+    typedef void const *clause_id_t;
+
+    struct entry
+    {
+      bool success;
+      char_stream::mark_t end;
+      unsigned linenumber;
+      long linestart;
+      context::state state;
+      replay_builder events;
+
+      entry(bool s, context const &ctx) :
+        success(s),
+        end(ctx.stream().mark()),
+        linenumber(ctx.linenumber()),
+        linestart(ctx.linestart()),
+        state(ctx.get_state())
+      {}
+    };
+
+    entry const *find(clause_id_t clause, char_stream::mark_t pos, context::state const &s) const;
+
+    entry const &insert(clause_id_t clause, char_stream::mark_t pos, context::state const &s, entry &&e);
+
+    void clear()
+    {
+      d_entries.clear();
+    }
+
+    size_t size() const
+    {
+      return d_entries.size();
+    }
+
+    // unique id per clause type
+    template <typename clause_t>
+    static clause_id_t id()
+    {
+      static const char tag = 0;
+      return &tag;
+    }
+
+  private:
+    struct key
+    {
+      clause_id_t clause;
+      char_stream::mark_t pos;
+      int indent_level;
+      context::blockflow_t blockflow;
+      context::chomp_t chomp;
+
+      key(clause_id_t c, char_stream::mark_t p, context::state const &s) :
+        clause(c),
+        pos(p),
+        indent_level(s.indent_level),
+        blockflow(s.blockflow),
+        chomp(s.chomp)
+      {}
+
+      bool operator==(key const &other) const
+      {
+        return
+          clause == other.clause &&
+          pos == other.pos &&
+          indent_level == other.indent_level &&
+          blockflow == other.blockflow &&
+          chomp == other.chomp;
+      }
+    };
+
+    struct key_hash
+    {
+      size_t operator()(key const &k) const;
+    };
+
+    std::unordered_map<key, entry, key_hash> d_entries;
+  };
+}
+
+#endif // MEMO_TABLE_HH
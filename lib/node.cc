@@ -1,7 +1,14 @@
 #include "node.hh"
 #include "node_visitor.hh"
+#include "node_arena.hh"
+#include "tag_table.hh"
+#include "core_schema.hh"
+#include "base64.hh"
 #include "utils.hh"
 #include <sstream>
+#include <cmath>
+#include <mutex>
+#include <thread>
 
 using namespace std;
 using namespace kyaml;
@@ -39,6 +46,115 @@ namespace
           " but was " +
           tostring_cast(actual));
   }
+
+  // for tags on nodes that are not built by a parser
+  tag_id intern_shared(string const &tag)
+  {
+    static mutex lock;
+    static tag_table table;
+
+    lock_guard<mutex> guard(lock);
+    return table.intern(tag);
+  }
+}
+
+tag_set::tag_set(tag_set const &other) :
+  d_first(other.d_first),
+  d_more(other.d_more ? new vector<tag_id>(*other.d_more) : nullptr)
+{}
+
+tag_set &tag_set::operator=(tag_set const &other)
+{
+  if(this != &other)
+  {
+    d_first = other.d_first;
+    d_more.reset(other.d_more ? new vector<tag_id>(*other.d_more) : nullptr);
+  }
+  return *this;
+}
+
+bool tag_set::contains(string_view tag) const
+{
+  for(size_t idx = 0; idx < size(); ++idx)
+  {
+    tag_id t = at(idx);
+    if(t->data() == tag.data() || *t == tag)
+      return true;
+  }
+  return false;
+}
+
+void tag_set::insert(tag_id tag)
+{
+  assert(tag);
+  if(contains(tag))
+    return;
+
+  if(!d_first)
+    d_first = tag;
+  else
+  {
+    if(!d_more)
+      d_more.reset(new vector<tag_id>);
+    d_more->push_back(tag);
+  }
+}
+
+bool tag_set::contains_more(tag_id tag) const
+{
+  for(tag_id t : *d_more)
+    if(t == tag)
+      return true;
+  return false;
+}
+
+node::node() :
+  d_home(nullptr)
+{}
+
+// a copy shares the arena of the original, as its children live there. nodes in an arena are
+// kept alive by the arena itself and must not hold on to it.
+
+node::node(node const &other) :
+  d_properties(other.d_properties),
+  d_arena(other.owner()),
+  d_home(nullptr)
+{}
+
+node::node(node &&other) :
+  d_properties(std::move(other.d_properties)),
+  d_arena(other.owner()),
+  d_home(nullptr)
+{}
+
+node &node::operator=(node const &other)
+{
+  d_properties = other.d_properties;
+  if(!d_home)
+    d_arena = other.owner();
+  return *this;
+}
+
+node &node::operator=(node &&other)
+{
+  d_properties = std::move(other.d_properties);
+  if(!d_home)
+    d_arena = other.owner();
+  return *this;
+}
+
+shared_ptr<node_arena> node::owner() const
+{
+  // arenas that are not shared (not built by a parser) are owned by the caller
+  return d_home ? d_home->weak_from_this().lock() : d_arena;
+}
+
+node::~node()
+{}
+
+void node::add_property(string const &prop)
+{
+  add_property(intern_shared(prop));
 }
 
 sequence const &node::as_sequence() const
@@ -72,6 +188,13 @@ string const &node::get() const
   throw std::logic_error("never reached");
 }
 
+string_view node::view() const
+{
+  assert(type() != SCALAR);
+  throw_type_error(SCALAR, type());
+  throw std::logic_error("never reached");
+}
+
 node const &node::get(size_t i) const
 {
   assert(type() != SEQUENCE);
@@ -79,7 +202,7 @@ node const &node::get(size_t i) const
   throw std::logic_error("never reached");
 }
 
-node const &node::get(const string &key) const
+node const &node::get(string_view key) const
 {
   assert(type() != MAPPING);
   throw_type_error(MAPPING, type());
@@ -102,22 +225,95 @@ void node::add(string const &key, std::shared_ptr<node> val)
   return dynamic_cast<mapping &>(*this).add(key, val);
 }
 
-node const &mapping::operator[](const string &key) const
+void node::add(node const *val)
+{
+  if(type() != SEQUENCE)
+    throw_type_error(SEQUENCE, type());
+
+  dynamic_cast<sequence &>(*this).add(val);
+}
+
+void node::add(string const &key, node const *val)
+{
+  if(type() != MAPPING)
+    throw_type_error(MAPPING, type());
+
+  dynamic_cast<mapping &>(*this).add(key, val);
+}
+
+node const &mapping::operator[](string_view key) const
 {
-  container_t::const_iterator it = d_items.find(key);
-  assert(it != d_items.end());
-  assert(it->second);
-  return *it->second;
+  size_t idx = find_index(key);
+  assert(idx != npos);
+  assert(d_items[idx].second);
+  return *d_items[idx].second;
 }
 
-node const &mapping::get(const string &key) const
+node const &mapping::get(string_view key) const
 {
-  container_t::const_iterator it = d_items.find(key);
-  if(it == d_items.end())
-    throw value_error(string("requested value ") + key + " not found");
+  size_t idx = find_index(key);
+  if(idx == npos)
+    throw value_error(string("requested value ") + string(key) + " not found");
 
-  assert(it->second);
-  return *it->second;
+  assert(d_items[idx].second);
+  return *d_items[idx].second;
+}
+
+size_t mapping::find_index(string_view key) const
+{
+  if(d_index.empty())
+  {
+    for(size_t idx = 0; idx < d_items.size(); ++idx)
+      if(d_items[idx].first == key)
+        return idx;
+    return npos;
+  }
+
+  size_t mask = d_index.size() - 1;
+  for(size_t slot = hash<string_view>()(key) & mask; d_index[slot]; slot = (slot + 1) & mask)
+  {
+    size_t idx = d_index[slot] - 1;
+    if(d_items[idx].first == key)
+      return idx;
+  }
+  return npos;
+}
+
+bool mapping::insert(string const &key, node const *value)
+{
+  if(find_index(key) != npos)
+    return false;
+
+  d_items.emplace_back(key, value);
+
+  if(d_items.size() > s_linear_max)
+  {
+    if(2 * d_items.size() > d_index.size())
+      rebuild_index();
+    else
+      index(d_items.size() - 1);
+  }
+  return true;
+}
+
+void mapping::index(size_t entry)
+{
+  size_t mask = d_index.size() - 1;
+  size_t slot = hash<string_view>()(d_items[entry].first) & mask;
+  while(d_index[slot])
+    slot = (slot + 1) & mask;
+  d_index[slot] = entry + 1;
+}
+
+void mapping::rebuild_index()
+{
+  size_t capacity = 4 * s_linear_max;
+  while(capacity < 4 * d_items.size())
+    capacity *= 2;
+
+  d_index.assign(capacity, 0);
+  for(size_t entry = 0; entry < d_items.size(); ++entry)
+    index(entry);
 }
 
 const string scalar::null_property = "!!null";
@@ -126,6 +322,101 @@ const string scalar::int_property = "!!int";
 const string scalar::float_property = "!!float";
 const string scalar::string_property = "!!str";
 const string scalar::binary_property = "!!binary";
+const string scalar::skipped_property = "!kyaml/skipped";
+
+void scalar::resolve(bool plain)
+{
+  string_view text = view();
+  properties_t const &tags = properties();
+
+  d_resolved = UNRESOLVED;
+  if(tags.contains(&string_property) || tags.contains(string_view("!")) || (tags.empty() && !plain))
+    d_resolved = STRING;
+  else if(tags.contains(&null_property) || (tags.empty() && core_null(text)))
+    d_resolved = NULL_VALUE;
+  else if((tags.empty() || tags.contains(&bool_property)) && core_bool(text, d_bool))
+    d_resolved = BOOL;
+  else if((tags.empty() || tags.contains(&int_property)) && core_int(text, d_int))
+    d_resolved = INT;
+  else if((tags.empty() || tags.contains(&float_property)) && core_float(text, d_float))
+    d_resolved = FLOAT;
+  else if(tags.empty())
+    d_resolved = STRING;
+}
+
+scalar::scalar(scalar const &other) :
+  node(other),
+  d_copied(NOT_COPIED)
+{
+  assign(other);
+}
+
+scalar::scalar(scalar &&other) :
+  node(std::move(other)),
+  d_copied(NOT_COPIED)
+{
+  assign(other);
+}
+
+scalar &scalar::operator=(scalar const &other)
+{
+  if(this != &other)
+  {
+    node::operator=(other);
+    assign(other);
+  }
+  return *this;
+}
+
+scalar &scalar::operator=(scalar &&other)
+{
+  if(this != &other)
+  {
+    node::operator=(std::move(other));
+    assign(other);
+  }
+  return *this;
+}
+
+// the value is taken through view(), so a borrowed one is copied without touching its d_value
+void scalar::assign(scalar const &other)
+{
+  d_value.assign(other.view());
+  d_view = string_view();
+  d_borrowed = false;
+  d_resolved = other.d_resolved;
+
+  switch(d_resolved)
+  {
+  case BOOL:
+    d_bool = other.d_bool;
+    break;
+  case INT:
+    d_int = other.d_int;
+    break;
+  case FLOAT:
+    d_float = other.d_float;
+    break;
+  default:
+    break;
+  }
+}
+
+void scalar::copy_borrowed() const
+{
+  // whoever gets here first copies, others wait for that to be done
+  copied_t expected = NOT_COPIED;
+  if(d_copied.compare_exchange_strong(expected, COPYING, memory_order_acquire))
+  {
+    d_value.assign(d_view);
+    d_copied.store(COPIED, memory_order_release);
+  }
+  else
+  {
+    while(d_copied.load(memory_order_acquire) != COPIED)
+      this_thread::yield();
+  }
+}
 
 void scalar::accept(node_visitor &visitor) const
 {
@@ -170,8 +461,13 @@ void mapping::accept(node_visitor &visitor) const
   visitor.sentinel(*this);
 }
 
+void kyaml::conversion::throw_out_of_range(string_view input)
+{
+  throw node::value_error(string("value ") + string(input) + " out of range");
+}
+
 template<>
-bool kyaml::type_convert(node::properties_t const &props, std::string const &input)
+bool kyaml::type_convert(node::properties_t const &props, string_view input)
 {
   string sanitized;
   for(char c : input)
@@ -192,26 +488,20 @@ bool kyaml::type_convert(node::properties_t const &props, std::string const &inp
       return false;
   }
 
-  // undefined, revert to default
-  return type_convert<int>(props, input);
+  // undefined, a number is true if its integer part is not zero
+  long double number;
+  return
+    parse_number(input, number) == NUMBER_OK &&
+    !std::isnan(number) &&
+    std::trunc(number) != 0;
 }
 
 template<>
-binary_t kyaml::type_convert(node::properties_t const &props, string const &input)
+binary_t kyaml::type_convert(node::properties_t const &props, string_view input)
 {
-  // sanitize whitespace
-  string sanitized;
-  for(char c : input)
-  {
-    if(isalnum(c) || c == '+' || c == '/' || c == '=')
-      sanitized += c;
-  }
-
   binary_t target;
-  if(decode_base64(sanitized, target))
-    return target;
-  else
-    return binary_t();
+  decode_base64(input, target); // leaves it empty if the input is not valid base64
+  return target;
 }
 
 namespace
@@ -227,7 +517,7 @@ namespace
     void visit(scalar const &val) override
     {
       comma();
-      d_out << val.get();
+      d_out << val.view();
       needscomma(true);
     }
 
@@ -0,0 +1,30 @@
+#include "node_arena.hh"
+#include <cassert>
+
+using namespace std;
+using namespace kyaml;
+
+node_arena::~node_arena()
+{
+  // children are plain pointers, so destroying a node never touches another one
+  for(auto it = d_nodes.rbegin(); it != d_nodes.rend(); ++it)
+    (*it)->~node();
+}
+
+void *node_arena::allocate(size_t size, size_t align)
+{
+  size_t padding = (align - reinterpret_cast<uintptr_t>(d_head) % align) % align;
+  if(!d_head || padding + size > d_left)
+  {
+    assert(size <= s_block_size);
+    d_blocks.emplace_back(new char[s_block_size]);
+    d_head = d_blocks.back().get();
+    d_left = s_block_size;
+    padding = (align - reinterpret_cast<uintptr_t>(d_head) % align) % align;
+  }
+
+  void *result = d_head + padding;
+  d_head += padding + size;
+  d_left -= padding + size;
+  return result;
+}
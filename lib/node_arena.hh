@@ -0,0 +1,59 @@
+#ifndef NODE_ARENA_HH
+#define NODE_ARENA_HH
+
+#include "node.hh"
+#include "utils.hh"
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace kyaml
+{
+  // owns the nodes of a parsed document. They are bump-allocated in large blocks and destroyed
+  // all together in a single loop, so there is no per-node allocation or recursive teardown.
+  // A parsed document shares it with copies of its nodes.
+  class node_arena : public std::enable_shared_from_this<node_arena>, private no_copy
+  {
+  public:
+    node_arena() :
+      d_head(nullptr),
+      d_left(0)
+    {}
+
+    ~node_arena();
+
+    template <typename node_t, typename... args_t>
+    node_t *create(args_t&&... args)
+    {
+      node_t *n = new(allocate(sizeof(node_t), alignof(node_t))) node_t(std::forward<args_t>(args)...);
+      static_cast<node *>(n)->d_home = this;
+      d_nodes.push_back(n);
+      return n;
+    }
+
+    size_t size() const
+    {
+      return d_nodes.size();
+    }
+
+    // keep p alive as long as the nodes, for anything they refer to
+    void keep(std::shared_ptr<void const> p)
+    {
+      if(p)
+        d_keep.push_back(std::move(p));
+    }
+
+  private:
+    void *allocate(size_t size, size_t align);
+
+    static const size_t s_block_size = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]> > d_blocks;
+    char *d_head;
+    size_t d_left;
+    std::vector<node *> d_nodes;
+    std::vector<std::shared_ptr<void const> > d_keep; // released after the nodes are gone
+  };
+}
+
+#endif // NODE_ARENA_HH
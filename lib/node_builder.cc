@@ -3,34 +3,12 @@
 using namespace std;
 using namespace kyaml;
 
-namespace
-{
-  template <typename t>
-  void dont_delete(t *p)
-  {}
-
-  class properties_node : public node
-  {
-  public:
-    type_t type() const
-    {
-      return SCALAR;
-    }
-
-    void accept(node_visitor &visitor) const
-    {}
-  };
-}
-
 namespace std
 {
-  ostream &operator<<(ostream &o, shared_ptr<node> n)
+  ostream &operator<<(ostream &o, node const *n)
   {
     if(n)
-    {
-      node const &nr = *n;
-      o << nr;
-    }
+      o << *n;
     else
       o << "(nullptr)";
     return o;
@@ -40,7 +18,7 @@ namespace std
 void node_builder::start_sequence(context const &ctx)
 {
   d_log("starting sequence");
-  push(SEQUENCE, ctx, std::unique_ptr<sequence>(new sequence));
+  push(SEQUENCE, ctx, create<sequence>());
 }
 
 void node_builder::end_sequence(context const &ctx)
@@ -53,7 +31,7 @@ void node_builder::end_sequence(context const &ctx)
 void node_builder::start_mapping(context const &ctx)
 {
   d_log("start mapping");
-  push(MAPPING, ctx, std::unique_ptr<mapping>(new mapping));
+  push(MAPPING, ctx, create<mapping>());
 }
 
 void node_builder::end_mapping(context const &ctx)
@@ -66,22 +44,19 @@ void node_builder::end_mapping(context const &ctx)
 void node_builder::add_anchor(context const &ctx, const string &anchor)
 {
   d_log("anchor", anchor);
-  push(ANCHOR, ctx, std::unique_ptr<scalar>(new scalar(anchor)));
+  d_stack.emplace(ANCHOR, ctx);
+  d_stack.top().name = anchor;
 }
 
 void node_builder::add_alias(context const &ctx, const string &alias)
 {
   d_log("alias", alias);
 
-  unordered_map<string, weak_ptr<node> >::const_iterator it = d_anchors.find(alias);
+  unordered_map<string, node *>::const_iterator it = d_anchors.find(alias);
   if(it != d_anchors.end())
   {
-    shared_ptr<node> sp = it->second.lock();
-    if(sp)
-    {
-      add_resolved_node(ctx, sp);
-      return;
-    }
+    add_resolved_node(ctx, it->second);
+    return;
   }
 
   d_errors.emplace_back(ctx, string("unknown alias '" + alias + "'"));
@@ -91,13 +66,40 @@ void node_builder::add_scalar(context const &ctx, const string &val)
 {
   d_log("scalar", val);
 
+  add_scalar_node(ctx, create<scalar>(val), false);
+}
+
+void node_builder::add_borrowed_scalar(context const &ctx, string_view val)
+{
+  d_log("borrowed scalar", val);
+
+  add_scalar_node(ctx, create_scalar(val, true), false);
+}
+
+void node_builder::add_plain_scalar(context const &ctx, string_view val, bool borrowed)
+{
+  d_log("plain scalar", val);
+
+  add_scalar_node(ctx, create_scalar(val, borrowed), true);
+}
+
+scalar *node_builder::create_scalar(string_view val, bool borrowed)
+{
+  if(borrowed && d_source)
+    return create<scalar>(scalar::borrowed_t(), val);
+  else
+    return create<scalar>(string(val));
+}
+
+void node_builder::add_scalar_node(context const &ctx, scalar *s, bool plain)
+{
+  if(d_resolve)
+    s->resolve(plain);
+
   if(d_stack.empty())
-    push(RESOLVED_NODE, ctx, unique_ptr<scalar>(new scalar(val)));
+    push(RESOLVED_NODE, ctx, s);
   else
-  {
-    shared_ptr<scalar> s = make_shared<scalar>(val);
     add_resolved_node(ctx, s);
-  }
 }
 
 void node_builder::add_property(context const &ctx, string const &prop)
@@ -105,17 +107,20 @@ void node_builder::add_property(context const &ctx, string const &prop)
   d_log("propery", prop);
 
   if(d_stack.empty() ||  d_stack.top().token != PROPERTY)
-    d_stack.emplace(PROPERTY, ctx, std::unique_ptr<properties_node>(new properties_node));
+  {
+    d_stack.emplace(PROPERTY, ctx);
+    d_stack.top().tags = d_pending_tags.size();
+  }
 
-  d_stack.top().value->add_property(prop);
+  d_pending_tags.push_back(d_tags->intern(prop));
 }
 
-void node_builder::add_resolved_node(context const &ctx, shared_ptr<node> s)
+void node_builder::add_resolved_node(context const &ctx, node *s)
 {
   if(d_stack.empty())
   {
     d_log("bare");
-    push_shared(RESOLVED_NODE, ctx, s);
+    push(RESOLVED_NODE, ctx, s);
   }
   else
   {
@@ -129,7 +134,7 @@ void node_builder::add_resolved_node(context const &ctx, shared_ptr<node> s)
 
     case MAPPING:
       d_log("using as key");
-      push_shared(MAPPING_KEY, ctx, s);
+      push(MAPPING_KEY, ctx, s);
       break;
 
     case MAPPING_KEY:
@@ -142,17 +147,22 @@ void node_builder::add_resolved_node(context const &ctx, shared_ptr<node> s)
     }
     case ANCHOR:
     {
-      item key = pop();
-      d_log("storing anchor", key.value->get(), s);
-      d_anchors.insert(make_pair(key.value->get(), s));
-      add_resolved_node(ctx, s); // or key.ctx?
+      item anchor = pop();
+      d_log("storing anchor", anchor.name, s);
+      d_anchors.insert(make_pair(std::move(anchor.name), s));
+      add_resolved_node(ctx, s); // or anchor.ctx?
       break;
     }
     case PROPERTY:
     {
       item props = pop();
-      for(std::string const &p : props.value->properties())
-        s->add_property(p);
+      for(size_t idx = props.tags; idx < d_pending_tags.size(); ++idx)
+        s->add_property(d_pending_tags[idx]);
+      d_pending_tags.resize(props.tags);
+
+      // tagged values resolve by their tag, no matter their style
+      if(d_resolve && s->type() == node::SCALAR)
+        static_cast<scalar *>(s)->resolve(false);
       add_resolved_node(ctx, s); // or props.ctx?
       break;
     }
@@ -163,22 +173,8 @@ void node_builder::add_resolved_node(context const &ctx, shared_ptr<node> s)
   }
 }
 
-void node_builder::push(node_builder::token_t t, context const &ctx, std::unique_ptr<node> v)
+void node_builder::push(node_builder::token_t t, context const &ctx, node *v)
 {
-  if(d_stack.empty())
-  {
-    // the top element in the stack is owned by d_root, not d_stack, so put shared_ptr with a no-op delete on top
-    d_root = std::move(v);
-    std::shared_ptr<node> sp(d_root.get(), dont_delete<node>);
-    d_stack.emplace(t, ctx, sp);
-  }
-  else
-    d_stack.emplace(t, ctx, std::move(v));
-}
-
-void node_builder::push_shared(token_t t, context const &ctx, std::shared_ptr<node> v)
-{
-  assert(!d_stack.empty());
   d_stack.emplace(t, ctx, v);
 }
 
@@ -189,6 +185,11 @@ void node_builder::add_atom(context const &ctx, char32_t c)
   // assert(false); // should not leak to this level
 }
 
+void node_builder::add_text(context const &ctx, string_view text)
+{
+  // like atoms, should not leak to this level
+}
+
 unique_ptr<node> node_builder::build()
 {
   struct cleaner
@@ -225,6 +226,9 @@ unique_ptr<node> node_builder::build()
 
   d_log("building", d_stack.top().value);
 
+  d_arena->keep(d_source);
+  d_arena->keep(d_tags);
+  d_root->d_arena = std::move(d_arena); // clear() sets up a new one
   return std::move(d_root);
 }
 
@@ -233,7 +237,9 @@ void node_builder::clear()
   d_stack = stack<item>();
   d_errors.clear();
   d_root.reset();
+  d_arena.reset(new node_arena);
   d_anchors.clear();
+  d_pending_tags.clear();
 }
 
 node_builder::item node_builder::pop()
@@ -254,7 +260,7 @@ void node_builder::resolve()
     d_stack.top().token = RESOLVED_NODE;
   else
   {
-    shared_ptr<node> rn = d_stack.top().value;
+    node *rn = d_stack.top().value;
     context ctx = d_stack.top().ctx;
     d_stack.pop();
 
@@ -4,16 +4,22 @@
 #include "node.hh"
 #include "kyaml.hh"
 #include "document_builder.hh"
+#include "node_arena.hh"
+#include "tag_table.hh"
 #include <stack>
+#include <unordered_map>
 
 namespace kyaml
 {
-  class node_builder : public document_builder
+  class node_builder final : public document_builder
   {
   public:
     typedef kyaml::parser::content_error content_error;
 
     node_builder() :
+      d_arena(new node_arena),
+      d_tags(new tag_table),
+      d_resolve(false),
       d_log("node builder")
     {}
 
@@ -35,6 +41,30 @@ namespace kyaml
 
     void add_atom(context const &ctx, char32_t c) override;
 
+    void add_text(context const &ctx, std::string_view text) override;
+
+    void add_borrowed_scalar(context const &ctx, std::string_view val) override;
+
+    void add_plain_scalar(context const &ctx, std::string_view val, bool borrowed) override;
+
+    // let scalars refer to the input buffer, source keeps it alive as long as the document
+    void borrow(std::shared_ptr<void const> source)
+    {
+      d_source = std::move(source);
+    }
+
+    // intern tags in a table shared with other builders, rather than one of our own
+    void share_tags(std::shared_ptr<tag_table> tags)
+    {
+      d_tags = std::move(tags);
+    }
+
+    // resolve scalars by the core schema as they are added, see scalar::resolve()
+    void resolve_scalars(bool resolve)
+    {
+      d_resolve = resolve;
+    }
+
     // may throw
     std::unique_ptr<node> build();
 
@@ -55,24 +85,41 @@ namespace kyaml
     {
       token_t token;
       context ctx;
-      std::shared_ptr<node> value;
+      node *value;
+      size_t tags; // PROPERTY: where its tags start in d_pending_tags
+      std::string name; // ANCHOR
 
-      item(token_t t, context const &c, std::shared_ptr<node> v = std::shared_ptr<node>()) :
+      item(token_t t, context const &c, node *v = nullptr) :
         token(t),
         ctx(c),
-        value(v)
+        value(v),
+        tags(0)
       {}
     };
 
     item pop();
 
     void resolve();
-    void add_resolved_node(context const &ctx, std::shared_ptr<node> s);
+    void add_resolved_node(context const &ctx, node *s);
+    scalar *create_scalar(std::string_view val, bool borrowed);
+    void add_scalar_node(context const &ctx, scalar *s, bool plain);
+
+    void push(token_t t, context const &ctx, node *v);
+
+    // the first node is the root, which is handed out by build() and so lives on the heap. All
+    // others are owned by the arena, which in turn is owned by the root.
+    template <typename node_t, typename... args_t>
+    node_t *create(args_t&&... args)
+    {
+      if(d_root)
+        return d_arena->create<node_t>(std::forward<args_t>(args)...);
 
-    void push(token_t t, context const &ctx, std::unique_ptr<node> v = std::unique_ptr<node>());
-    void push_shared(token_t t, context const &ctx, std::shared_ptr<node> v);
+      node_t *n = new node_t(std::forward<args_t>(args)...);
+      d_root.reset(n);
+      return n;
+    }
 
-    std::unordered_map<std::string, std::weak_ptr<node> > d_anchors;
+    std::unordered_map<std::string, node *> d_anchors;
 
     struct error
     {
@@ -88,6 +135,11 @@ namespace kyaml
 
     std::stack<item> d_stack;
     std::unique_ptr<node> d_root;
+    std::unique_ptr<node_arena> d_arena;
+    std::shared_ptr<void const> d_source;
+    std::shared_ptr<tag_table> d_tags;
+    std::vector<tag_id> d_pending_tags; // for the nodes to come
+    bool d_resolve;
 
     logger<false> d_log;
   };
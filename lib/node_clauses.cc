@@ -132,10 +132,16 @@ single_text::single_text(context &ctx) :
 
 bool single_text::parse(document_builder &builder)
 {
+  if(builder.discards())
+    return d_dispatch && (this->*d_dispatch)(builder);
+
   string_builder sb;
   if(d_dispatch && (this->*d_dispatch)(sb))
   {
-    builder.add_scalar(ctx(), sb.build());
+    if(!sb.borrowed().empty())
+      builder.add_borrowed_scalar(ctx(), sb.borrowed());
+    else
+      builder.add_scalar(ctx(), sb.build());
     return true;
   }
   return false;
@@ -281,41 +287,52 @@ bool plain_char::followed_by_plain_safe(context &ctx)
 
 bool plain::parse(document_builder &builder)
 {
+  // no need to collect the text if it is thrown away anyway
+  if(builder.discards())
+    return parse_text(builder);
+
   string_builder sb;
+  if(parse_text(sb))
+  {
+    if(!sb.borrowed().empty())
+      builder.add_plain_scalar(ctx(), sb.borrowed(), true);
+    else
+      builder.add_plain_scalar(ctx(), sb.build(), false);
+    return true;
+  }
+  return false;
+}
 
+bool plain::parse_text(document_builder &builder)
+{
   switch(ctx().blockflow())
   {
   case context::FLOW_OUT:
   case context::FLOW_IN:
   {
     plain_multi_line pml(ctx());
-    if(pml.parse(sb))
-    {
-      builder.add_scalar(ctx(), sb.build());
+    if(pml.parse(builder))
       return true;
-    }
   }
 
   case context::BLOCK_KEY:
   case context::FLOW_KEY:
   {
     plain_one_line pol(ctx());
-    if(pol.parse(sb))
-    {
-      builder.add_scalar(ctx(), sb.build());
-      return true;
-    }
+    return pol.parse(builder);
   }
 
   default:
-    break;
+    return false;
   }
-  return false;
 }
 
 
 bool kyaml::clauses::double_text::parse(kyaml::document_builder &builder)
 {
+  if(builder.discards())
+    return d_dispatch && (this->*d_dispatch)(builder);
+
   string_builder sb;
   if(d_dispatch && (this->*d_dispatch)(sb))
   {
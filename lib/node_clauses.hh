@@ -27,6 +27,9 @@ namespace kyaml
     {
     public:
       using clause::clause;
+
+      static constexpr char_set first_chars = "&";
+      static constexpr bool nullable = false;
       
       bool parse(document_builder &builder);
 
@@ -65,6 +68,9 @@ namespace kyaml
     public:
       using clause::clause;
 
+      static constexpr char_set first_chars = "!";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
     };
 
@@ -87,6 +93,9 @@ namespace kyaml
     {
     public:
       using clause::clause;
+
+      static constexpr char_set first_chars = "*";
+      static constexpr bool nullable = false;
       
       bool parse(document_builder &builder);
       
@@ -102,7 +111,8 @@ namespace kyaml
     public:
       using clause::clause;
 
-      bool parse(document_builder &builder)
+      template <typename builder_t>
+      bool parse(builder_t &builder)
       {
         builder.add_scalar(ctx(), "");
         return true;
@@ -118,20 +128,30 @@ namespace kyaml
     // [106] 	e-node 	::= 	e-scalar
     typedef escalar enode;
 
+    // nb-double-char without the escapes, taken as it is
+    typedef internal::all_of<internal::not_clause<internal::simple_char_clause<'\\'> >,
+                             internal::not_clause<internal::simple_char_clause<'"'> >,
+                             json> unescaped_double_char;
+
     // [107] 	nb-double-char 	::= 	c-ns-esc-char | ( nb-json - “\” - “"” )
     typedef internal::or_clause<esc_char,
-                                internal::all_of<internal::not_clause<internal::simple_char_clause<'\\'> >,
-                                                 internal::not_clause<internal::simple_char_clause<'"'> >,
-                                                 json>
+                                unescaped_double_char
                                > nonbreak_double_char;
 
     // [108] 	ns-double-char 	::= 	nb-double-char - s-white
     typedef internal::and_clause<internal::not_clause<white>,
                                  nonbreak_double_char> nonspace_double_char;
 
+    typedef internal::and_clause<internal::not_clause<white>,
+                                 unescaped_double_char> unescaped_nonspace_double_char;
+
     // [114] 	nb-ns-double-in-line 	::= 	( s-white* ns-double-char )*
-    typedef internal::zero_or_more<internal::and_clause<internal::zero_or_more<white>,
-                                                        nonspace_double_char>
+    // runs without escapes are emitted as a whole
+    typedef internal::zero_or_more<internal::or_clause<internal::verbatim<internal::one_or_more<internal::and_clause<internal::zero_or_more<white>,
+                                                                                                                   unescaped_nonspace_double_char> > >,
+                                                       internal::and_clause<internal::zero_or_more<white>,
+                                                                            nonspace_double_char>
+                                                      >
                                   > nonbreak_nonspace_double_inline;
 
     // [112] 	s-double-escaped(n) 	::= 	s-white* “\” b-non-content
@@ -158,7 +178,8 @@ namespace kyaml
         d_impl(ctx)
       {}
 
-      bool parse(document_builder &builder)
+      template <typename builder_t>
+      bool parse(builder_t &builder)
       {
         return d_impl.parse(builder);
       }
@@ -187,7 +208,9 @@ namespace kyaml
                                 > double_multi_line;
 
     // [111] 	nb-double-one-line 	::= 	nb-double-char*
-    typedef internal::zero_or_more<nonbreak_double_char> double_one_line;
+    typedef internal::zero_or_more<internal::or_clause<internal::verbatim<internal::one_or_more<unescaped_double_char> >,
+                                                       esc_char>
+                                  > double_one_line;
 
     // [110] 	nb-double-text(n,c) 	::= 	c = flow-out  ⇒ nb-double-multi-line(n)
     //                                    c = flow-in   ⇒ nb-double-multi-line(n)
@@ -217,22 +240,34 @@ namespace kyaml
     typedef internal::and_clause<internal::simple_char_clause<'\'', false>,
                                  internal::simple_char_clause<'\'', true> > quoted_quote;
 
+    // nb-single-char without the quoted quote, taken as it is
+    typedef internal::and_clause<internal::not_clause<internal::simple_char_clause<'\''> >,
+                                 json> unquoted_single_char;
+
     // [118] 	nb-single-char 	::= 	c-quoted-quote | ( nb-json - “'” )
     typedef internal::or_clause<quoted_quote,
-                                internal::and_clause<internal::not_clause<internal::simple_char_clause<'\''> >,
-                                                     json>
+                                unquoted_single_char
                                > nonbreak_single_char;
 
     // [119] 	ns-single-char 	::= 	nb-single-char - s-white
     typedef internal::and_clause<internal::not_clause<white>,
                                  nonbreak_single_char> nonspace_single_char;
 
+    typedef internal::and_clause<internal::not_clause<white>,
+                                 unquoted_single_char> unquoted_nonspace_single_char;
+
     // [122] 	nb-single-one-line 	::= 	nb-single-char*
-    typedef internal::zero_or_more<nonbreak_single_char> single_one_line;
+    typedef internal::zero_or_more<internal::or_clause<internal::verbatim<internal::one_or_more<unquoted_single_char> >,
+                                                       quoted_quote>
+                                  > single_one_line;
 
     // [123] 	nb-ns-single-in-line 	::= 	( s-white* ns-single-char )*
-    typedef internal::zero_or_more<internal::and_clause<internal::zero_or_more<white>,
-                                                        nonspace_single_char>
+    // runs without quoted quotes are emitted as a whole
+    typedef internal::zero_or_more<internal::or_clause<internal::verbatim<internal::one_or_more<internal::and_clause<internal::zero_or_more<white>,
+                                                                                                                   unquoted_nonspace_single_char> > >,
+                                                       internal::and_clause<internal::zero_or_more<white>,
+                                                                            nonspace_single_char>
+                                                      >
                                   > nonbreak_nonspace_single_inline;
 
     // [124] 	s-single-next-line(n) 	::= 	s-flow-folded(n)
@@ -246,7 +281,8 @@ namespace kyaml
         d_impl(ctx)
       {}
 
-      bool parse(document_builder &builder)
+      template <typename builder_t>
+      bool parse(builder_t &builder)
       {
         return d_impl.parse(builder);
       }
@@ -314,7 +350,8 @@ namespace kyaml
     public:
       plain_safe(context &ctx);
 
-      bool parse(document_builder &builder)
+      template <typename builder_t>
+      bool parse(builder_t &builder)
       {
         return d_dispatch ? (this->*d_dispatch)(builder) : false;
       }
@@ -370,11 +407,11 @@ namespace kyaml
     };
 
     // [132] 	nb-ns-plain-in-line(c) 	::= 	( s-white* ns-plain-char(c) )*
-    typedef internal::zero_or_more<internal::and_clause<internal::zero_or_more<white>,
-                                                        plain_char> > plain_in_line;
+    typedef internal::verbatim<internal::zero_or_more<internal::and_clause<internal::zero_or_more<white>,
+                                                                           plain_char> > > plain_in_line;
 
     // [133] 	ns-plain-one-line(c) 	::= 	ns-plain-first(c) nb-ns-plain-in-line(c)
-    typedef internal::and_clause<plain_first, plain_in_line> plain_one_line;                                 
+    typedef internal::verbatim<internal::and_clause<plain_first, plain_in_line> > plain_one_line;                                 
    
     // [134] 	s-ns-plain-next-line(n,c) 	::= 	s-flow-folded(n)
     //                                                  ns-plain-char(c) nb-ns-plain-in-line(c)
@@ -396,7 +433,14 @@ namespace kyaml
     public:
       using clause::clause;
 
+      // ns-plain-first, that is ns-char minus the indicators except “-”, “?” and “:”
+      static constexpr char_set first_chars = char_set::all() - " \t\r\n" - ",[]{}#&*!>\'\"%@`";
+      static constexpr bool nullable = false;
+
       bool parse(document_builder &builder);
+
+    private:
+      bool parse_text(document_builder &builder);
     };
   }
 }
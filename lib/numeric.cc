@@ -0,0 +1,202 @@
+#include "numeric.hh"
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <string>
+
+using namespace std;
+using namespace kyaml;
+
+namespace
+{
+  bool is_space(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+  }
+
+  // a number taken apart: sign, base and the digits (or float text) without separators
+  class number_text
+  {
+  public:
+    number_text(string_view text) :
+      d_negative(false),
+      d_base(10)
+    {
+      while(!text.empty() && is_space(text.front()))
+        text.remove_prefix(1);
+      while(!text.empty() && is_space(text.back()))
+        text.remove_suffix(1);
+
+      if(!text.empty() && (text[0] == '-' || text[0] == '+'))
+      {
+        d_negative = text[0] == '-';
+        text.remove_prefix(1);
+      }
+
+      if(text.size() > 2 && text[0] == '0')
+      {
+        switch(text[1])
+        {
+        case 'x':
+          d_base = 16;
+          break;
+        case 'o':
+          d_base = 8;
+          break;
+        case 'b':
+          d_base = 2;
+          break;
+        }
+        if(d_base != 10)
+          text.remove_prefix(2);
+      }
+
+      // separators only between digits, so "_1" or "1_" stay invalid
+      if(text.find('_') != string_view::npos &&
+         text.front() != '_' &&
+         text.back() != '_')
+      {
+        for(char c : text)
+          if(c != '_')
+            d_copy += c;
+        text = d_copy;
+      }
+      d_digits = text;
+    }
+
+    bool negative() const
+    {
+      return d_negative;
+    }
+
+    int base() const
+    {
+      return d_base;
+    }
+
+    string_view digits() const
+    {
+      return d_digits;
+    }
+
+  private:
+    bool d_negative;
+    int d_base;
+    string_view d_digits;
+    string d_copy; // only used if there were separators
+  };
+
+  // the magnitude of an integer
+  number_result_t parse_magnitude(number_text const &num, uint64_t &value)
+  {
+    string_view digits = num.digits();
+    if(digits.empty() || digits[0] == '-' || digits[0] == '+')
+      return NUMBER_INVALID;
+
+    char const *end = digits.data() + digits.size();
+    from_chars_result r = from_chars(digits.data(), end, value, num.base());
+    if(r.ptr != end)
+      return NUMBER_INVALID;
+    if(r.ec == errc::result_out_of_range)
+      return NUMBER_OUT_OF_RANGE;
+    return r.ec == errc() ? NUMBER_OK : NUMBER_INVALID;
+  }
+
+  template <typename float_t>
+  number_result_t parse_float(string_view text, float_t &value)
+  {
+    number_text num(text);
+
+    // integers in another base are fine too
+    if(num.base() != 10)
+    {
+      uint64_t magnitude;
+      number_result_t r = parse_magnitude(num, magnitude);
+      if(r == NUMBER_OK)
+        value = num.negative() ? -static_cast<float_t>(magnitude) : static_cast<float_t>(magnitude);
+      return r;
+    }
+
+    string_view digits = num.digits();
+    if(digits == ".inf" || digits == ".Inf" || digits == ".INF")
+    {
+      value = num.negative() ? -numeric_limits<float_t>::infinity() : numeric_limits<float_t>::infinity();
+      return NUMBER_OK;
+    }
+    if(digits == ".nan" || digits == ".NaN" || digits == ".NAN")
+    {
+      value = numeric_limits<float_t>::quiet_NaN();
+      return NUMBER_OK;
+    }
+
+    if(digits.empty() || digits[0] == '-' || digits[0] == '+')
+      return NUMBER_INVALID;
+
+    float_t result;
+    char const *end = digits.data() + digits.size();
+    from_chars_result r = from_chars(digits.data(), end, result);
+    if(r.ptr != end || (r.ec != errc() && r.ec != errc::result_out_of_range))
+      return NUMBER_INVALID;
+
+    if(r.ec == errc::result_out_of_range)
+    {
+      // too small is not an error, it just is zero
+      size_t exp = digits.find_first_of("eE");
+      if(exp == string_view::npos || exp + 1 >= digits.size() || digits[exp + 1] != '-')
+        return NUMBER_OUT_OF_RANGE;
+      result = 0;
+    }
+
+    value = num.negative() ? -result : result;
+    return NUMBER_OK;
+  }
+}
+
+number_result_t kyaml::parse_number(string_view text, int64_t &value)
+{
+  number_text num(text);
+
+  uint64_t magnitude;
+  number_result_t r = parse_magnitude(num, magnitude);
+  if(r != NUMBER_OK)
+    return r;
+
+  uint64_t limit = static_cast<uint64_t>(numeric_limits<int64_t>::max()) + (num.negative() ? 1 : 0);
+  if(magnitude > limit)
+    return NUMBER_OUT_OF_RANGE;
+
+  // negate in unsigned arithmetic, so the minimum works as well
+  value = num.negative() ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+  return NUMBER_OK;
+}
+
+number_result_t kyaml::parse_number(string_view text, uint64_t &value)
+{
+  number_text num(text);
+
+  uint64_t magnitude;
+  number_result_t r = parse_magnitude(num, magnitude);
+  if(r != NUMBER_OK)
+    return r;
+
+  if(num.negative() && magnitude != 0)
+    return NUMBER_OUT_OF_RANGE;
+
+  value = magnitude;
+  return NUMBER_OK;
+}
+
+number_result_t kyaml::parse_number(string_view text, float &value)
+{
+  return parse_float(text, value);
+}
+
+number_result_t kyaml::parse_number(string_view text, double &value)
+{
+  return parse_float(text, value);
+}
+
+number_result_t kyaml::parse_number(string_view text, long double &value)
+{
+  return parse_float(text, value);
+}
@@ -0,0 +1,284 @@
+#include "path_filter.hh"
+#include "node.hh"
+#include <stdexcept>
+
+using namespace std;
+using namespace kyaml;
+
+namespace
+{
+  void malformed(string const &pattern)
+  {
+    throw invalid_argument("malformed path pattern \"" + pattern + "\"");
+  }
+}
+
+path_pattern::path_pattern(string const &pattern)
+{
+  size_t i = 0;
+  while(i < pattern.size())
+  {
+    segment s;
+    s.index = 0;
+
+    if(pattern[i] == '[')
+    {
+      size_t close = pattern.find(']', i);
+      if(close == string::npos)
+        malformed(pattern);
+
+      string idx = pattern.substr(i + 1, close - i - 1);
+      if(idx == "*")
+        s.type = segment::ANY_INDEX;
+      else
+      {
+        if(idx.empty() || idx.find_first_not_of("0123456789") != string::npos)
+          malformed(pattern);
+        s.type = segment::INDEX;
+        s.index = stoul(idx);
+      }
+      i = close + 1;
+    }
+    else
+    {
+      size_t end = min(pattern.find_first_of(".[", i), pattern.size());
+      s.key = pattern.substr(i, end - i);
+      if(s.key.empty())
+        malformed(pattern);
+      s.type = s.key == "*" ? segment::ANY_KEY : segment::KEY;
+      i = end;
+    }
+
+    d_segments.push_back(s);
+
+    if(i < pattern.size() && pattern[i] == '.' && ++i == pattern.size())
+      malformed(pattern);
+  }
+}
+
+bool path_pattern::matches(size_t pos, string_view key) const
+{
+  assert(pos < size());
+  segment const &s = d_segments[pos];
+  return
+    s.type == segment::ANY_KEY ||
+    (s.type == segment::KEY && s.key == key);
+}
+
+bool path_pattern::matches(size_t pos, size_t index) const
+{
+  assert(pos < size());
+  segment const &s = d_segments[pos];
+  return
+    s.type == segment::ANY_INDEX ||
+    (s.type == segment::INDEX && s.index == index);
+}
+
+path_filter::path_filter(vector<path_pattern> const &patterns, document_builder &target) :
+  d_patterns(patterns),
+  d_target(target),
+  d_keep(0),
+  d_skip(0)
+{}
+
+void path_filter::start_sequence(context const &ctx)
+{
+  if(start_node(ctx, SEQUENCE, nullptr))
+    d_target.start_sequence(ctx);
+}
+
+void path_filter::end_sequence(context const &ctx)
+{
+  if(end_node(ctx))
+    d_target.end_sequence(ctx);
+}
+
+void path_filter::start_mapping(context const &ctx)
+{
+  if(start_node(ctx, MAPPING, nullptr))
+    d_target.start_mapping(ctx);
+}
+
+void path_filter::end_mapping(context const &ctx)
+{
+  if(end_node(ctx))
+    d_target.end_mapping(ctx);
+}
+
+void path_filter::add_anchor(context const &ctx, string const &anchor)
+{
+  if(d_keep)
+    d_target.add_anchor(ctx, anchor);
+  else if(!d_skip)
+    d_pending.add_anchor(ctx, anchor);
+}
+
+void path_filter::add_alias(context const &ctx, string const &alias)
+{
+  if(start_node(ctx, LEAF, nullptr))
+    d_target.add_alias(ctx, alias);
+}
+
+void path_filter::add_scalar(context const &ctx, string const &val)
+{
+  string_view key = val;
+  if(start_node(ctx, LEAF, &key))
+    d_target.add_scalar(ctx, val);
+}
+
+void path_filter::add_borrowed_scalar(context const &ctx, string_view val)
+{
+  if(start_node(ctx, LEAF, &val))
+    d_target.add_borrowed_scalar(ctx, val);
+}
+
+void path_filter::add_plain_scalar(context const &ctx, string_view val, bool borrowed)
+{
+  if(start_node(ctx, LEAF, &val))
+    d_target.add_plain_scalar(ctx, val, borrowed);
+}
+
+void path_filter::add_property(context const &ctx, string const &prop)
+{
+  if(d_keep)
+    d_target.add_property(ctx, prop);
+  else if(!d_skip)
+    d_pending.add_property(ctx, prop);
+}
+
+bool path_filter::start_node(context const &ctx, node_t type, string_view const *key)
+{
+  if(d_skip)
+  {
+    if(type != LEAF)
+      ++d_skip;
+    return false;
+  }
+  if(d_keep)
+  {
+    if(type != LEAF)
+      ++d_keep;
+    return true;
+  }
+
+  cursors_t cursors;
+  if(d_frames.empty())
+  {
+    for(size_t i = 0; i < d_patterns.size(); ++i)
+      cursors.push_back(cursor{i, 0});
+  }
+  else if(d_frames.back().mapping)
+  {
+    frame &f = d_frames.back();
+    if(f.expect_key)
+    {
+      // whether the key is needed depends on what happens to its value, so hold it back
+      f.expect_key = false;
+      f.value.clear();
+      if(type == LEAF && key)
+        f.value = advance(f.cursors, *key);
+
+      // only keys that are held back get copied
+      if(!f.value.empty())
+        d_pending.add_scalar(ctx, string(*key));
+      else
+      {
+        d_pending.truncate(0);
+        if(type != LEAF)
+          d_skip = 1;
+      }
+      return false;
+    }
+
+    f.expect_key = true;
+    cursors.swap(f.value);
+  }
+  else
+  {
+    frame &f = d_frames.back();
+    cursors = advance(f.cursors, f.index++);
+  }
+
+  decision_t decision = decide(cursors);
+  if(decision == FILTER && type == LEAF) // the pattern goes deeper than the document
+    decision = DROP;
+
+  if(decision == DROP)
+  {
+    d_pending.truncate(0);
+    if(type != LEAF)
+      d_skip = 1;
+    if(!d_frames.empty() && !d_frames.back().mapping)
+      ++d_frames.back().gap;
+    return false;
+  }
+
+  if(!d_frames.empty() && !d_frames.back().mapping)
+  {
+    for(; d_frames.back().gap > 0; --d_frames.back().gap)
+    {
+      d_target.add_property(ctx, scalar::skipped_property);
+      d_target.add_scalar(ctx, "");
+    }
+  }
+  d_pending.replay(d_target);
+  d_pending.truncate(0);
+
+  if(decision == KEEP)
+  {
+    if(type != LEAF)
+      d_keep = 1;
+  }
+  else
+    d_frames.push_back(frame{type == MAPPING, cursors, 0, 0, true, cursors_t()});
+
+  return true;
+}
+
+bool path_filter::end_node(context const &ctx)
+{
+  if(d_skip)
+  {
+    --d_skip;
+    return false;
+  }
+  if(d_keep)
+  {
+    --d_keep;
+    return true;
+  }
+
+  assert(!d_frames.empty());
+  d_frames.pop_back();
+  return true;
+}
+
+path_filter::cursors_t path_filter::advance(cursors_t const &from, string_view key) const
+{
+  cursors_t result;
+  for(cursor const &c : from)
+    if(c.pos < d_patterns[c.pattern].size() && d_patterns[c.pattern].matches(c.pos, key))
+      result.push_back(cursor{c.pattern, c.pos + 1});
+  return result;
+}
+
+path_filter::cursors_t path_filter::advance(cursors_t const &from, size_t index) const
+{
+  cursors_t result;
+  for(cursor const &c : from)
+    if(c.pos < d_patterns[c.pattern].size() && d_patterns[c.pattern].matches(c.pos, index))
+      result.push_back(cursor{c.pattern, c.pos + 1});
+  return result;
+}
+
+path_filter::decision_t path_filter::decide(cursors_t const &cursors) const
+{
+  if(cursors.empty())
+    return DROP;
+
+  for(cursor const &c : cursors)
+    if(c.pos == d_patterns[c.pattern].size())
+      return KEEP;
+
+  return FILTER;
+}
@@ -0,0 +1,126 @@
+#ifndef PATH_FILTER_HH
+#define PATH_FILTER_HH
+
+#include "document_builder.hh"
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace kyaml
+{
+  // a path into a document, like "spec.containers[*].image". Segments are mapping keys separated
+  // by dots, or sequence indices in brackets. "*" and "[*]" match any key or index.
+  class path_pattern
+  {
+  public:
+    struct segment
+    {
+      typedef enum
+      {
+        KEY,
+        ANY_KEY,
+        INDEX,
+        ANY_INDEX,
+      } type_t;
+
+      type_t type;
+      std::string key;
+      size_t index;
+    };
+
+    // throws std::invalid_argument if the pattern is malformed
+    path_pattern(std::string const &pattern);
+
+    size_t size() const
+    {
+      return d_segments.size();
+    }
+
+    bool matches(size_t pos, std::string_view key) const;
+    bool matches(size_t pos, size_t index) const;
+
+  private:
+    std::vector<segment> d_segments;
+  };
+
+  // forwards only the events for the parts of the document that match one of the patterns, and
+  // the collections leading up to them. Everything else is dropped before it reaches the target.
+  // Sequence entries before a match are kept as empty scalars tagged scalar::skipped_property, so
+  // indices stay the same.
+  // Note that aliases in the selection can only refer to anchors in the selection.
+  class path_filter final : public document_builder
+  {
+  public:
+    path_filter(std::vector<path_pattern> const &patterns, document_builder &target);
+
+    void start_sequence(context const &ctx) override;
+    void end_sequence(context const &ctx) override;
+    void start_mapping(context const &ctx) override;
+    void end_mapping(context const &ctx) override;
+
+    void add_anchor(context const &ctx, std::string const &anchor) override;
+    void add_alias(context const &ctx, std::string const &alias) override;
+    void add_scalar(context const &ctx, std::string const &val) override;
+    void add_borrowed_scalar(context const &ctx, std::string_view val) override;
+    void add_plain_scalar(context const &ctx, std::string_view val, bool borrowed) override;
+    void add_property(context const &ctx, std::string const &prop) override;
+
+    void add_atom(context const &ctx, char32_t c) override
+    {}
+
+    void add_text(context const &ctx, std::string_view text) override
+    {}
+
+  private:
+    // how far each pattern got
+    struct cursor
+    {
+      size_t pattern;
+      size_t pos;
+    };
+    typedef std::vector<cursor> cursors_t;
+
+    // a collection on the way to a match
+    struct frame
+    {
+      bool mapping;
+      cursors_t cursors;
+      size_t index;          // sequences: the index of the next entry
+      size_t gap;            // sequences: dropped entries since the last forwarded one
+      bool expect_key;       // mappings: the next node is a key
+      cursors_t value;       // mappings: cursors for the value of the current key
+    };
+
+    typedef enum
+    {
+      DROP,
+      FILTER,
+      KEEP,
+    } decision_t;
+
+    typedef enum
+    {
+      SEQUENCE,
+      MAPPING,
+      LEAF,
+    } node_t;
+
+    // called for the start of every node, returns true if its events should be forwarded
+    bool start_node(context const &ctx, node_t type, std::string_view const *key);
+    bool end_node(context const &ctx);
+
+    cursors_t advance(cursors_t const &from, std::string_view key) const;
+    cursors_t advance(cursors_t const &from, size_t index) const;
+    decision_t decide(cursors_t const &cursors) const;
+
+    std::vector<path_pattern> d_patterns;
+    document_builder &d_target;
+
+    std::vector<frame> d_frames;
+    replay_builder d_pending; // properties, anchors and keys of the node to come
+    size_t d_keep;            // nesting depth inside a fully selected collection
+    size_t d_skip;            // nesting depth inside a dropped collection
+  };
+}
+
+#endif // PATH_FILTER_HH
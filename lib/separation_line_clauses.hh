@@ -20,7 +20,8 @@ namespace kyaml
     public:
       separate(context &ctx);
 
-      bool parse(document_builder &builder)
+      template <typename builder_t>
+      bool parse(builder_t &builder)
       {
         return d_dispatch ? (this->*d_dispatch)(builder) : false;
       }
@@ -42,7 +42,8 @@ namespace kyaml
     public:
       line_prefix(context &ctx);
 
-      bool parse(document_builder &builder)
+      template <typename builder_t>
+      bool parse(builder_t &builder)
       {
         return d_dispatch ? (this->*d_dispatch)(builder) : false;
       }
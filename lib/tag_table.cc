@@ -0,0 +1,28 @@
+#include "tag_table.hh"
+
+using namespace std;
+using namespace kyaml;
+
+tag_table::tag_table()
+{
+  for(tag_id known : {&scalar::null_property,
+                      &scalar::bool_property,
+                      &scalar::int_property,
+                      &scalar::float_property,
+                      &scalar::string_property,
+                      &scalar::binary_property,
+                      &scalar::skipped_property})
+    d_index.emplace(*known, known);
+}
+
+tag_id tag_table::intern(string_view tag)
+{
+  auto it = d_index.find(tag);
+  if(it != d_index.end())
+    return it->second;
+
+  d_storage.emplace_back(tag);
+  tag_id id = &d_storage.back();
+  d_index.emplace(*id, id);
+  return id;
+}
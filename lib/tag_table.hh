@@ -0,0 +1,27 @@
+#ifndef TAG_TABLE_HH
+#define TAG_TABLE_HH
+
+#include "node.hh"
+#include "utils.hh"
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
+namespace kyaml
+{
+  // interns tags, each distinct text is stored once and never moves, so the address is its id.
+  // The well-known tags map to the scalar::*_property strings. Not thread safe.
+  class tag_table : private no_copy
+  {
+  public:
+    tag_table();
+
+    tag_id intern(std::string_view tag);
+
+  private:
+    std::unordered_map<std::string_view, tag_id> d_index;
+    std::deque<std::string> d_storage;
+  };
+}
+
+#endif // TAG_TABLE_HH
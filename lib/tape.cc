@@ -0,0 +1,179 @@
+#include "tape.hh"
+#include "utils.hh"
+#include <cassert>
+
+using namespace std;
+using namespace kyaml;
+
+namespace
+{
+  char const *type_name(node::type_t t)
+  {
+    switch(t)
+    {
+    case node::MAPPING:
+      return "mapping";
+    case node::SEQUENCE:
+      return "sequence";
+    default:
+      return "scalar";
+    }
+  }
+
+  void throw_type_error(node::type_t expect, node::type_t actual)
+  {
+    throw node::type_error(
+          string("node type mismatch: expected ") +
+          type_name(expect) +
+          " but was " +
+          type_name(actual));
+  }
+}
+
+size_t tape::skip(size_t index) const
+{
+  while(type(d_entries[index]) == TAG)
+    index += 2;
+
+  switch(type(d_entries[index]))
+  {
+  case START_SEQUENCE:
+  case START_MAPPING:
+    return payload(d_entries[index]);
+  case SCALAR:
+    return index + 2;
+  case ALIAS:
+    return index + 1;
+  default:
+    assert(false);
+    return index + 1;
+  }
+}
+
+tape::item::item(tape const &t, size_t index) :
+  d_tape(&t),
+  d_index(index),
+  d_body(index)
+{
+  while(tape::type(t.d_entries[d_body]) == TAG)
+    d_body += 2;
+
+  if(tape::type(t.d_entries[d_body]) == ALIAS)
+  {
+    d_index = payload(t.d_entries[d_body]);
+    d_body = d_index;
+    while(tape::type(t.d_entries[d_body]) == TAG)
+      d_body += 2;
+  }
+}
+
+node::type_t tape::item::type() const
+{
+  switch(tape::type(d_tape->d_entries[d_body]))
+  {
+  case START_SEQUENCE:
+    return node::SEQUENCE;
+  case START_MAPPING:
+    return node::MAPPING;
+  default:
+    return node::SCALAR;
+  }
+}
+
+string_view tape::item::get() const
+{
+  if(type() != node::SCALAR)
+    throw_type_error(node::SCALAR, type());
+  return d_tape->text(d_body);
+}
+
+tape::item tape::item::get(size_t idx) const
+{
+  if(type() != node::SEQUENCE)
+    throw_type_error(node::SEQUENCE, type());
+
+  size_t found;
+  if(!find(idx, found))
+    throw node::value_error(string("list index ") + tostring_cast(idx) + " out of range");
+  return item(*d_tape, found);
+}
+
+tape::item tape::item::get(string_view key) const
+{
+  if(type() != node::MAPPING)
+    throw_type_error(node::MAPPING, type());
+
+  size_t found;
+  if(!find(key, found))
+    throw node::value_error(string("requested value ") + string(key) + " not found");
+  return item(*d_tape, found);
+}
+
+size_t tape::item::size() const
+{
+  size_t count = 0;
+  for(iterator it = begin(); it != end(); ++it)
+    ++count;
+
+  return type() == node::MAPPING ? count / 2 : count;
+}
+
+vector<string_view> tape::item::properties() const
+{
+  vector<string_view> result;
+  for(size_t i = d_index; i < d_body; i += 2)
+    result.push_back(d_tape->text(i));
+  return result;
+}
+
+bool tape::item::has_property(string_view prop) const
+{
+  for(size_t i = d_index; i < d_body; i += 2)
+    if(d_tape->text(i) == prop)
+      return true;
+  return false;
+}
+
+tape::iterator tape::item::begin() const
+{
+  return type() == node::SCALAR ? end() : iterator(*d_tape, d_body + 1);
+}
+
+tape::iterator tape::item::end() const
+{
+  // the entry before the skip target is the matching end
+  return type() == node::SCALAR ?
+    iterator(*d_tape, d_body) :
+    iterator(*d_tape, payload(d_tape->d_entries[d_body]) - 1);
+}
+
+bool tape::item::find(size_t idx, size_t &found) const
+{
+  size_t i = 0;
+  for(iterator it = begin(); it != end(); ++it, ++i)
+  {
+    if(i == idx)
+    {
+      found = it.index();
+      return true;
+    }
+  }
+  return false;
+}
+
+bool tape::item::find(string_view key, size_t &found) const
+{
+  for(iterator it = begin(); it != end(); ++it)
+  {
+    item k = *it;
+    ++it;
+    assert(it != end());
+
+    if(k.type() == node::SCALAR && k.get() == key)
+    {
+      found = it.index();
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,147 @@
+#include "tape_builder.hh"
+#include <cassert>
+#include <sstream>
+
+using namespace std;
+using namespace kyaml;
+
+tape_builder::tape_builder() :
+  d_pending(string::npos)
+{}
+
+void tape_builder::start_sequence(context const &ctx)
+{
+  start_collection(tape::START_SEQUENCE);
+}
+
+void tape_builder::end_sequence(context const &ctx)
+{
+  end_collection(tape::END_SEQUENCE);
+}
+
+void tape_builder::start_mapping(context const &ctx)
+{
+  start_collection(tape::START_MAPPING);
+}
+
+void tape_builder::end_mapping(context const &ctx)
+{
+  end_collection(tape::END_MAPPING);
+}
+
+void tape_builder::add_anchor(context const &ctx, string const &anchor)
+{
+  if(d_pending == string::npos)
+    d_pending = d_tape.d_entries.size();
+  d_anchor = anchor;
+}
+
+void tape_builder::add_alias(context const &ctx, string const &alias)
+{
+  string anchor;
+  begin_node(anchor);
+
+  auto it = d_anchors.find(alias);
+  if(it != d_anchors.end())
+    push(tape::ALIAS, it->second);
+  else
+  {
+    if(!d_error)
+    {
+      stringstream str;
+      str << "Content error at line " << ctx.linenumber() << ": unknown alias '" << alias << "'";
+      d_error.reset(new content_error(ctx.linenumber(), str.str()));
+    }
+
+    // keep the tape well-formed
+    push_text(tape::SCALAR, "");
+  }
+}
+
+void tape_builder::add_scalar(context const &ctx, string const &val)
+{
+  string anchor;
+  size_t node = begin_node(anchor);
+
+  push_text(tape::SCALAR, val);
+  if(!anchor.empty())
+    d_anchors[anchor] = node;
+}
+
+void tape_builder::add_property(context const &ctx, string const &prop)
+{
+  if(d_pending == string::npos)
+    d_pending = d_tape.d_entries.size();
+  push_text(tape::TAG, prop);
+}
+
+tape tape_builder::build()
+{
+  if(d_tape.d_entries.empty())
+    push_text(tape::SCALAR, "");
+
+  unique_ptr<content_error> error(std::move(d_error));
+  tape result(std::move(d_tape));
+  clear();
+
+  if(error)
+    throw *error;
+
+  assert(d_open.empty());
+  return result;
+}
+
+void tape_builder::clear()
+{
+  d_tape = tape();
+  d_open.clear();
+  d_anchors.clear();
+  d_pending = string::npos;
+  d_anchor.clear();
+  d_error.reset();
+}
+
+size_t tape_builder::begin_node(string &anchor)
+{
+  size_t node = d_pending == string::npos ? d_tape.d_entries.size() : d_pending;
+  d_pending = string::npos;
+  anchor.swap(d_anchor);
+  d_anchor.clear();
+  return node;
+}
+
+void tape_builder::start_collection(tape::entry_t type)
+{
+  open_collection c;
+  c.node = begin_node(c.anchor);
+  c.start = d_tape.d_entries.size();
+  d_open.push_back(std::move(c));
+
+  push(type, 0); // the skip target is filled in at the end
+}
+
+void tape_builder::end_collection(tape::entry_t type)
+{
+  assert(!d_open.empty());
+  open_collection &c = d_open.back();
+
+  push(type, c.start);
+  d_tape.d_entries[c.start] |= d_tape.d_entries.size();
+
+  if(!c.anchor.empty())
+    d_anchors[c.anchor] = c.node;
+  d_open.pop_back();
+}
+
+void tape_builder::push(tape::entry_t type, uint64_t payload)
+{
+  assert(payload == tape::payload(payload));
+  d_tape.d_entries.push_back((uint64_t(type) << 56) | payload);
+}
+
+void tape_builder::push_text(tape::entry_t type, string const &text)
+{
+  push(type, d_tape.d_strings.size());
+  d_tape.d_entries.push_back(text.size());
+  d_tape.d_strings.append(text);
+}
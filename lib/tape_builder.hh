@@ -0,0 +1,67 @@
+#ifndef TAPE_BUILDER_HH
+#define TAPE_BUILDER_HH
+
+#include "tape.hh"
+#include "kyaml.hh"
+#include "document_builder.hh"
+#include <unordered_map>
+
+namespace kyaml
+{
+  class tape_builder final : public document_builder
+  {
+  public:
+    typedef kyaml::parser::content_error content_error;
+
+    tape_builder();
+
+    void start_sequence(context const &ctx) override;
+    void end_sequence(context const &ctx) override;
+    void start_mapping(context const &ctx) override;
+    void end_mapping(context const &ctx) override;
+
+    void add_anchor(context const &ctx, std::string const &anchor) override;
+    void add_alias(context const &ctx, std::string const &alias) override;
+    void add_scalar(context const &ctx, std::string const &val) override;
+    void add_property(context const &ctx, std::string const &prop) override;
+
+    void add_atom(context const &ctx, char32_t c) override
+    {}
+
+    void add_text(context const &ctx, std::string_view text) override
+    {}
+
+    // may throw
+    tape build();
+
+    void clear();
+
+  private:
+    struct open_collection
+    {
+      size_t start;       // index of the start entry
+      size_t node;        // where the node starts, including its tags
+      std::string anchor; // to register once the collection is complete
+    };
+
+    // bookkeeping for a node about to be added, returns where it starts including its tags
+    size_t begin_node(std::string &anchor);
+
+    void start_collection(tape::entry_t type);
+    void end_collection(tape::entry_t type);
+
+    void push(tape::entry_t type, uint64_t payload);
+    void push_text(tape::entry_t type, std::string const &text);
+
+    tape d_tape;
+    std::vector<open_collection> d_open;
+    std::unordered_map<std::string, size_t> d_anchors;
+
+    size_t d_pending;        // start of the tags for the next node, or npos
+    std::string d_anchor;    // anchor for the next node
+
+    std::unique_ptr<content_error> d_error;
+  };
+}
+
+#endif // TAPE_BUILDER_HH
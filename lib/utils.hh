@@ -45,7 +45,21 @@ namespace kyaml
   }
 
   bool is_valid_utf8(std::string const &str);
-  bool is_valid_utf8(char32_t c);
+
+  // c holds the packed utf8 bytes of a single character, as in append_utf8()
+  inline bool is_valid_utf8(char32_t c)
+  {
+    const size_t size = c > 0xffffff ? 4 : c > 0xffff ? 3 : c > 0xff ? 2 : 1;
+    const size_t count = nr_utf8bytes(c >> (8 * (size - 1)));
+    if(size < count)
+      return false;
+
+    for(size_t i = 1; i < count; ++i)
+      if(!is_continuation_byte(c >> (8 * (size - 1 - i))))
+        return false;
+
+    return true;
+  }
 
   // note: these do not check for validity
   bool extract_utf8(std::istream &stream, char32_t &result);
@@ -58,9 +72,6 @@ namespace kyaml
     str.append(s);
   }
 
-  // base 64 decoding
-  bool decode_base64(std::string const &source, std::vector<uint8_t> &target);
-
   template <typename T>
   std::string tostring_cast(T const &val)
   {
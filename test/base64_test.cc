@@ -0,0 +1,111 @@
+#include "base64.hh"
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace std;
+using namespace kyaml;
+
+namespace
+{
+  string encode(vector<uint8_t> const &data, size_t wrap = 0)
+  {
+    static const char digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    string result;
+    for(size_t i = 0; i < data.size(); i += 3)
+    {
+      uint32_t bits = data[i] << 16;
+      if(i + 1 < data.size())
+        bits |= data[i + 1] << 8;
+      if(i + 2 < data.size())
+        bits |= data[i + 2];
+
+      result += digits[(bits >> 18) & 0x3f];
+      result += digits[(bits >> 12) & 0x3f];
+      result += i + 1 < data.size() ? digits[(bits >> 6) & 0x3f] : '=';
+      result += i + 2 < data.size() ? digits[bits & 0x3f] : '=';
+    }
+
+    if(wrap)
+    {
+      string wrapped;
+      for(size_t i = 0; i < result.size(); i += wrap)
+        wrapped += "  " + result.substr(i, wrap) + "\n";
+      result = wrapped;
+    }
+    return result;
+  }
+
+  vector<uint8_t> random_bytes(size_t n, mt19937 &rng)
+  {
+    vector<uint8_t> result(n);
+    for(uint8_t &b : result)
+      b = rng();
+    return result;
+  }
+}
+
+TEST(base64, round_trip)
+{
+  mt19937 rng(42);
+  for(size_t n = 0; n < 300; ++n)
+  {
+    vector<uint8_t> data = random_bytes(n, rng);
+    for(size_t wrap : {0, 4, 60, 76})
+    {
+      vector<uint8_t> decoded;
+      ASSERT_TRUE(decode_base64(encode(data, wrap), decoded)) << n << " " << wrap;
+      EXPECT_EQ(data, decoded) << n << " " << wrap;
+    }
+  }
+}
+
+TEST(base64, into_buffer)
+{
+  mt19937 rng(7);
+  vector<uint8_t> data = random_bytes(1000, rng);
+  string source = encode(data);
+
+  vector<uint8_t> buffer(base64_decoded_size(source.size()));
+  size_t written = 0;
+  ASSERT_TRUE(decode_base64(source, buffer.data(), buffer.size(), written));
+  EXPECT_EQ(data.size(), written);
+  EXPECT_TRUE(equal(data.begin(), data.end(), buffer.begin()));
+
+  EXPECT_FALSE(decode_base64(source, buffer.data(), data.size() - 1, written));
+}
+
+TEST(base64, appends)
+{
+  vector<uint8_t> target = {'>'};
+  ASSERT_TRUE(decode_base64("aGk=", target));
+  EXPECT_EQ(vector<uint8_t>({'>', 'h', 'i'}), target);
+}
+
+TEST(base64, invalid)
+{
+  for(string_view s : {"a", "abc", "ab=c", "a===", "ab*d", "QQ==QQ==", "QQ=", "QUJD\x80", "=QUJ"})
+  {
+    vector<uint8_t> target;
+    EXPECT_FALSE(decode_base64(s, target)) << s;
+    EXPECT_TRUE(target.empty()) << s;
+  }
+
+  // an invalid character deep inside a long run, where the vectorized decoder would see it
+  mt19937 rng(3);
+  string source = encode(random_bytes(300, rng));
+  source[150] = '-';
+  vector<uint8_t> target;
+  EXPECT_FALSE(decode_base64(source, target));
+}
+
+TEST(base64, padding_and_space)
+{
+  vector<uint8_t> target;
+  ASSERT_TRUE(decode_base64(" QU\nJD\tRA = =\n", target));
+  EXPECT_EQ(vector<uint8_t>({'A', 'B', 'C', 'D'}), target);
+
+  target.clear();
+  ASSERT_TRUE(decode_base64("", target));
+  EXPECT_TRUE(target.empty());
+}
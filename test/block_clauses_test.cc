@@ -308,3 +308,32 @@ TEST(folded_content, with_indents)
 }
 }
 
+
+TEST(block_sequence, streams_entries)
+{
+  string input = "- a\n"
+                 "- b\n"
+                 "- c\n";
+
+  context_wrap ctx(input, -1, context::BLOCK_IN);
+
+  // each entry should arrive as soon as it is complete, not after the whole sequence
+  vector<size_t> received;
+  auto record = [&] { received.push_back(ctx.get().stream().pos()); };
+
+  mock_builder mb;
+  testing::InSequence seq;
+  EXPECT_CALL(mb, start_sequence()).WillOnce(testing::InvokeWithoutArgs(record));
+  EXPECT_CALL(mb, add_scalar("a")).WillOnce(testing::InvokeWithoutArgs(record));
+  EXPECT_CALL(mb, add_scalar("b")).WillOnce(testing::InvokeWithoutArgs(record));
+  EXPECT_CALL(mb, add_scalar("c")).WillOnce(testing::InvokeWithoutArgs(record));
+  EXPECT_CALL(mb, end_sequence()).WillOnce(testing::InvokeWithoutArgs(record));
+
+  block_sequence bs(ctx.get());
+  EXPECT_TRUE(bs.parse(mb));
+
+  ASSERT_EQ(5u, received.size());
+  EXPECT_LT(received[1], 8u);
+  EXPECT_LT(received[2], 12u);
+  EXPECT_LE(received[1], received[2]);
+}
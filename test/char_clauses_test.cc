@@ -1,4 +1,5 @@
 #include "char_clauses.hh"
+#include "char_class.hh"
 #include "flow_clauses.hh"
 #include "clause_test.hh"
 #include "node_clauses.hh"
@@ -309,3 +310,19 @@ CHAR_CLAUSE_TEST(nonbreak_double_char,
 CHAR_CLAUSE_TEST(nonspace_double_char,
                  values({"\\a", "\\b", "a", "1"}),
                  values({"\\", "\"", " "}))
+
+TEST(char_class, table)
+{
+  using namespace kyaml::char_class;
+
+  EXPECT_EQ(PRINTABLE | JSON | NON_BREAK | NON_WHITE | WORD | URI | ASCII_LETTER | HEX_DIGIT, classify('a'));
+  EXPECT_EQ(PRINTABLE | JSON | NON_BREAK | NON_WHITE | INDICATOR | FLOW_INDICATOR | URI, classify('['));
+  EXPECT_EQ(PRINTABLE | JSON | NON_BREAK | WHITE, classify(' '));
+  EXPECT_EQ(PRINTABLE | BREAK, classify('\n'));
+  EXPECT_EQ(JSON, classify(0x7f));
+  EXPECT_EQ(0, classify(0x10));
+  EXPECT_EQ(0, classify(0x85)); // not a character on its own
+
+  EXPECT_EQ(multibyte, classify(0xe282ac));
+  EXPECT_EQ(0, classify(0xe282));
+}
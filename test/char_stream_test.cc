@@ -105,3 +105,85 @@ TEST(char_stream_test, consume)
   cs.get(c);
   EXPECT_EQ(seq[2], c);
 }
+
+TEST(char_stream_test, multibyte)
+{
+  stringstream str("a\xd5\x82" "b");
+  char_stream cs(str);
+
+  char_t c;
+  EXPECT_TRUE(cs.get(c));
+  EXPECT_EQ('a', c);
+  EXPECT_TRUE(cs.get(c));
+  EXPECT_EQ(0xd582u, c);
+  EXPECT_TRUE(cs.rpeek(c));
+  EXPECT_EQ(0xd582u, c);
+  EXPECT_EQ(2u, cs.pos());
+  EXPECT_TRUE(cs.get(c));
+  EXPECT_EQ('b', c);
+  EXPECT_FALSE(cs.get(c));
+}
+
+TEST(char_stream_test, unwind_multibyte)
+{
+  stringstream str("\xe2\x82\xac" "a");
+  char_stream cs(str);
+
+  char_stream::mark_t m = cs.mark();
+
+  char_t c;
+  cs.get(c), cs.get(c);
+  EXPECT_EQ(2u, cs.pos());
+
+  cs.unwind(m);
+  EXPECT_EQ(0u, cs.pos());
+  cs.get(c);
+  EXPECT_EQ(0xe282acu, c);
+}
+
+TEST(char_stream_test, large_input)
+{
+  string seq(200 * 1024, 'x');
+  seq += "\xd5\x82";
+  stringstream str(seq);
+  char_stream cs(str);
+
+  cs.advance(200 * 1024);
+
+  char_t c;
+  EXPECT_TRUE(cs.get(c));
+  EXPECT_EQ(0xd582u, c);
+  EXPECT_TRUE(cs.eof());
+}
+
+TEST(char_stream_test, indent_level)
+{
+  stringstream str("ab\n  \xd5\x82" "c");
+  char_stream cs(str);
+
+  cs.advance(6);
+  EXPECT_EQ(3u, cs.indent_level());
+  EXPECT_EQ(3u, cs.indent_level(1));
+}
+
+TEST(char_stream_test, buffer)
+{
+  string seq = "a\xd5\x82" "bc";
+  string_view view(seq);
+  char_stream cs(view);
+
+  char_t c;
+  cs.get(c), cs.get(c);
+  EXPECT_EQ(0xd582u, c);
+  EXPECT_EQ("a\xd5\x82", cs.consume());
+  EXPECT_FALSE(cs.rpeek(c));
+
+  char_stream::mark_t m = cs.mark();
+  cs.get(c);
+  EXPECT_EQ('b', c);
+  EXPECT_EQ("b", cs.consume(m));
+  cs.get(c);
+  EXPECT_EQ('c', c);
+  EXPECT_FALSE(cs.get(c));
+  EXPECT_TRUE(cs.eof());
+}
@@ -40,3 +40,225 @@ NAMED_CLAUSE_TEST(all_of_test,
                   all_of_abc,
                   cases({a_tc("abc", true, 3),
                         a_tc("bca", false)}))
+
+namespace
+{
+  // adds an event before it finds out it doesn't match
+  class emit_then_fail : public clause
+  {
+  public:
+    using clause::clause;
+
+    bool parse(document_builder &builder)
+    {
+      builder.add_atom(ctx(), 'x');
+      return false;
+    }
+  };
+}
+
+TEST(all_of_test, tail_fails_after_output)
+{
+  context_wrap cw("ab");
+
+  string_builder sb;
+  EXPECT_FALSE((internal::all_of<simple_char_clause<'a', false>, emit_then_fail>(cw.get()).parse(sb)));
+  EXPECT_EQ("", sb.build());
+  EXPECT_EQ(0u, cw.get().stream().pos());
+}
+
+TEST(all_of_test, restricted_tail_can_fail)
+{
+  context_wrap cw("ab");
+
+  // zero_or_one can't fail, but restricted to a context that isn't there it does
+  string_builder sb;
+  EXPECT_FALSE((internal::all_of<simple_char_clause<'a'>,
+                                 flow_restriction<zero_or_one<simple_char_clause<'b'> >, context::FLOW_IN> >(cw.get()).parse(sb)));
+  EXPECT_EQ("", sb.build());
+  EXPECT_EQ(0u, cw.get().stream().pos());
+}
+
+TEST(all_of_test, discarding_builder)
+{
+  static_assert(discards_v<null_builder>);
+  static_assert(!discards_v<document_builder>);
+
+  // no log to roll back, the stream is still restored
+  context_wrap cw("abd");
+  null_builder nb;
+  EXPECT_FALSE(all_of_abc(cw.get()).parse(nb));
+  EXPECT_EQ(0u, cw.get().stream().pos());
+
+  context_wrap cw2("abc");
+  EXPECT_TRUE(all_of_abc(cw2.get()).parse(nb));
+  EXPECT_EQ(3u, cw2.get().stream().pos());
+}
+
+TEST(memoize_test, hit)
+{
+  context_wrap cw("ab");
+  memo_table memo;
+  cw.get().set_memo(&memo);
+
+  typedef memoize<all_of_abc> memo_abc;
+  typedef memoize<any_of_abc> memo_any;
+
+  replay_builder rb;
+  EXPECT_FALSE(memo_abc(cw.get()).parse(rb));
+  EXPECT_EQ(1u, memo.size());
+  EXPECT_EQ(0u, cw.get().stream().pos());
+
+  // second time around the result comes from the table
+  EXPECT_FALSE(memo_abc(cw.get()).parse(rb));
+  EXPECT_EQ(1u, memo.size());
+
+  EXPECT_TRUE(memo_any(cw.get()).parse(rb));
+  EXPECT_EQ(2u, memo.size());
+  EXPECT_EQ(1u, cw.get().stream().pos());
+
+  cw.get().stream().unwind(0);
+  EXPECT_TRUE(memo_any(cw.get()).parse(rb));
+  EXPECT_EQ(2u, memo.size());
+  EXPECT_EQ(1u, cw.get().stream().pos());
+}
+
+TEST(event_guard_test, rollback)
+{
+  context_wrap cw("");
+  document_builder::context dc(cw.get());
+
+  string_builder target;
+  {
+    event_guard outer(target);
+    outer.builder().add_scalar(dc, "a");
+    {
+      event_guard inner(outer.builder());
+      inner.builder().add_scalar(dc, "b");
+      // no release, rolled back
+    }
+    {
+      event_guard inner(outer.builder());
+      inner.builder().add_scalar(dc, "c");
+      inner.release();
+    }
+
+    // nothing is forwarded before the outermost release
+    EXPECT_EQ("", target.build());
+    outer.release();
+  }
+
+  EXPECT_EQ("ac", target.build());
+}
+
+namespace
+{
+  // only takes atoms, relies on the default add_text()
+  class atom_builder : public document_builder
+  {
+  public:
+    void start_sequence(context const &ctx) override
+    {}
+
+    void end_sequence(context const &ctx) override
+    {}
+
+    void start_mapping(context const &ctx) override
+    {}
+
+    void end_mapping(context const &ctx) override
+    {}
+
+    void add_anchor(context const &ctx, std::string const &) override
+    {}
+
+    void add_alias(context const &ctx, std::string const &) override
+    {}
+
+    void add_scalar(context const &ctx, std::string const &) override
+    {}
+
+    void add_property(context const &ctx, std::string const &) override
+    {}
+
+    void add_atom(context const &ctx, char32_t c) override
+    {
+      atoms.push_back(c);
+    }
+
+    vector<char32_t> atoms;
+  };
+}
+
+TEST(verbatim_test, text)
+{
+  context_wrap cw("abcd");
+
+  replay_builder rb;
+  EXPECT_TRUE(verbatim<one_or_more<any_of_abc> >(cw.get()).parse(rb));
+  EXPECT_EQ(1u, rb.size());
+  EXPECT_EQ(3u, cw.get().stream().pos());
+
+  string_builder sb;
+  rb.replay(sb);
+  EXPECT_EQ("abc", sb.build());
+
+  EXPECT_FALSE(verbatim<one_or_more<any_of_abc> >(cw.get()).parse(rb));
+  EXPECT_EQ(1u, rb.size());
+}
+
+TEST(verbatim_test, atoms)
+{
+  context_wrap cw("");
+  document_builder::context dc(cw.get());
+
+  atom_builder ab;
+  ab.add_text(dc, u8"aé€");
+
+  ASSERT_EQ(3u, ab.atoms.size());
+  EXPECT_EQ(char32_t('a'), ab.atoms[0]);
+  EXPECT_EQ(char32_t(0xc3a9), ab.atoms[1]);
+  EXPECT_EQ(char32_t(0xe282ac), ab.atoms[2]);
+}
+
+TEST(event_guard_test, discard)
+{
+  // nothing to log if the events are thrown away anyway
+  null_builder nb;
+  event_guard eg(nb);
+  EXPECT_EQ(&nb, &eg.builder());
+}
+
+TEST(first_set_test, char_set)
+{
+  constexpr char_set s = char_set("ab") | char_set::single(0xc3a9);
+  EXPECT_TRUE(s.contains('a'));
+  EXPECT_TRUE(s.contains('b'));
+  EXPECT_FALSE(s.contains('c'));
+  EXPECT_TRUE(s.contains(0xe282ac)); // all non-ascii is lumped together
+
+  constexpr char_set t = char_set::all() - "b";
+  EXPECT_TRUE(t.contains('a'));
+  EXPECT_FALSE(t.contains('b'));
+  EXPECT_TRUE(t.contains('~'));
+}
+
+TEST(first_set_test, combinators)
+{
+  typedef first_set<any_of_abc> any_first;
+  EXPECT_TRUE(any_first::chars.contains('c'));
+  EXPECT_FALSE(any_first::chars.contains('d'));
+  EXPECT_FALSE(any_first::nullable);
+
+  typedef first_set<internal::all_of<zero_or_one<simple_char_clause<'a'> >, simple_char_clause<'b'> > > all_first;
+  EXPECT_TRUE(all_first::chars.contains('a'));
+  EXPECT_TRUE(all_first::chars.contains('b'));
+  EXPECT_FALSE(all_first::nullable);
+
+  typedef first_set<internal::all_of<simple_char_clause<'a'>, simple_char_clause<'b'> > > seq_first;
+  EXPECT_FALSE(seq_first::chars.contains('b'));
+
+  // undeclared, anything goes
+  EXPECT_TRUE(first_set<printable>::nullable);
+  EXPECT_TRUE(first_set<printable>::viable('x', true));
+}
@@ -0,0 +1,74 @@
+#include "core_schema.hh"
+#include <gtest/gtest.h>
+#include <cmath>
+
+using namespace std;
+using namespace kyaml;
+
+TEST(core_schema, null)
+{
+  for(string_view s : {"", "~", "null", "Null", "NULL"})
+    EXPECT_TRUE(core_null(s)) << s;
+  for(string_view s : {"nULL", "none", "0"})
+    EXPECT_FALSE(core_null(s)) << s;
+}
+
+TEST(core_schema, bool)
+{
+  bool b = false;
+  EXPECT_TRUE(core_bool("True", b));
+  EXPECT_TRUE(b);
+  EXPECT_TRUE(core_bool("FALSE", b));
+  EXPECT_FALSE(b);
+  for(string_view s : {"yes", "No", "tRue", "1", ""})
+    EXPECT_FALSE(core_bool(s, b)) << s;
+}
+
+class core_int_test : public testing::TestWithParam<pair<string, int64_t> >
+{};
+
+TEST_P(core_int_test, valid)
+{
+  int64_t v = 0;
+  EXPECT_TRUE(core_int(GetParam().first, v));
+  EXPECT_EQ(GetParam().second, v);
+}
+
+INSTANTIATE_TEST_SUITE_P(core_schema,
+                         core_int_test,
+                         testing::Values(make_pair("0", 0),
+                                         make_pair("-19", -19),
+                                         make_pair("+12345", 12345),
+                                         make_pair("0o14", 12),
+                                         make_pair("0x1aF", 0x1af),
+                                         make_pair("9223372036854775807", numeric_limits<int64_t>::max()),
+                                         make_pair("-9223372036854775808", numeric_limits<int64_t>::min())));
+
+TEST(core_schema, not_int)
+{
+  int64_t v = 0;
+  for(string_view s : {"", "-", "1.0", "0x", "0o8", "-0x1", "1_000", "12a", "9223372036854775808"})
+    EXPECT_FALSE(core_int(s, v)) << s;
+}
+
+TEST(core_schema, float)
+{
+  double v = 0;
+  EXPECT_TRUE(core_float("1.5", v));
+  EXPECT_DOUBLE_EQ(1.5, v);
+  EXPECT_TRUE(core_float("+.5", v));
+  EXPECT_DOUBLE_EQ(0.5, v);
+  EXPECT_TRUE(core_float("-2.", v));
+  EXPECT_DOUBLE_EQ(-2.0, v);
+  EXPECT_TRUE(core_float("6.8523015e+5", v));
+  EXPECT_DOUBLE_EQ(685230.15, v);
+  EXPECT_TRUE(core_float("12", v));
+  EXPECT_DOUBLE_EQ(12.0, v);
+  EXPECT_TRUE(core_float("-.inf", v));
+  EXPECT_TRUE(isinf(v) && v < 0);
+  EXPECT_TRUE(core_float(".NaN", v));
+  EXPECT_TRUE(isnan(v));
+
+  for(string_view s : {"", ".", "-", "1e", "1.5.", "e3", ".Nan", "inf", "1e999"})
+    EXPECT_FALSE(core_float(s, v)) << s;
+}
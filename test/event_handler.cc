@@ -0,0 +1,183 @@
+#include "kyaml.hh"
+#include <sstream>
+#include <map>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace kyaml;
+
+namespace
+{
+  class recording_handler : public event_handler
+  {
+  public:
+    void start_sequence(position const &pos) override
+    {
+      record(pos, "+SEQ");
+    }
+
+    void end_sequence(position const &pos) override
+    {
+      record(pos, "-SEQ");
+    }
+
+    void start_mapping(position const &pos) override
+    {
+      record(pos, "+MAP");
+    }
+
+    void end_mapping(position const &pos) override
+    {
+      record(pos, "-MAP");
+    }
+
+    void scalar(position const &pos, string const &value) override
+    {
+      record(pos, "=VAL " + value);
+    }
+
+    void alias(position const &pos, string const &name) override
+    {
+      record(pos, "=ALI " + name);
+    }
+
+    void anchor(position const &pos, string const &name) override
+    {
+      record(pos, "&" + name);
+    }
+
+    void tag(position const &pos, string const &tag) override
+    {
+      record(pos, "TAG " + tag);
+    }
+
+    vector<string> events;
+    vector<position> positions;
+
+  private:
+    void record(position const &pos, string const &event)
+    {
+      events.push_back(event);
+      positions.push_back(pos);
+    }
+  };
+
+  // the line the parser is at when each scalar arrives
+  class line_handler : public recording_handler
+  {
+  public:
+    line_handler(parser const &p) :
+      d_parser(p)
+    {}
+
+    void scalar(position const &pos, string const &value) override
+    {
+      lines[value] = d_parser.linenumber();
+    }
+
+    map<string, unsigned> lines;
+
+  private:
+    parser const &d_parser;
+  };
+
+  vector<string> parse_events(string const &input)
+  {
+    stringstream stream(input);
+    parser p(stream);
+
+    recording_handler h;
+    p.parse(h);
+    return h.events;
+  }
+}
+
+TEST(event_handler, structure)
+{
+  vector<string> expect = {
+    "+MAP",
+    "=VAL key",
+    "+SEQ",
+    "=VAL a",
+    "&anchor",
+    "=VAL b",
+    "-SEQ",
+    "=VAL other",
+    "=ALI anchor",
+    "-MAP",
+  };
+
+  EXPECT_EQ(expect, parse_events("key:\n"
+                                 "  - a\n"
+                                 "  - &anchor b\n"
+                                 "other: *anchor\n"));
+}
+
+TEST(event_handler, tag)
+{
+  vector<string> expect = {
+    "+SEQ",
+    "TAG !!str",
+    "=VAL 1",
+    "-SEQ",
+  };
+
+  EXPECT_EQ(expect, parse_events("[ !!str 1 ]"));
+}
+
+TEST(event_handler, positions)
+{
+  stringstream stream("a: b\n"
+                      "cc: dd\n");
+  parser p(stream);
+
+  recording_handler h;
+  p.parse(h);
+
+  ASSERT_EQ(6u, h.events.size());
+  EXPECT_EQ("=VAL dd", h.events[4]);
+  EXPECT_EQ(2u, h.positions[4].line);
+  EXPECT_EQ(7u, h.positions[4].column);
+}
+
+TEST(event_handler, invalid)
+{
+  stringstream stream("[ a\n");
+  parser p(stream);
+
+  recording_handler h;
+  EXPECT_THROW(p.parse(h), parser::parse_error);
+}
+
+TEST(event_handler, streams_explicit_document)
+{
+  parser p("---\n"
+           "- a\n"
+           "- b\n"
+           "- c\n"
+           "- d\n");
+
+  line_handler h(p);
+  p.parse(h);
+
+  // the entries arrive as they are read, not when the document is complete
+  EXPECT_LE(h.lines["a"], 3u);
+  EXPECT_LT(h.lines["a"], h.lines["d"]);
+}
+
+TEST(event_handler, streams_nested_collection)
+{
+  parser p("items:\n"
+           "  - a\n"
+           "  - b\n"
+           "  - c\n"
+           "  - d\n");
+
+  line_handler h(p);
+  p.parse(h);
+
+  // not held back until the first entry of the outer mapping is complete
+  EXPECT_LE(h.lines["items"], 2u);
+  EXPECT_LE(h.lines["a"], 3u);
+  EXPECT_LT(h.lines["a"], h.lines["d"]);
+}
@@ -0,0 +1,299 @@
+#include "kyaml.hh"
+#include "event_reader.hh"
+#include "sample_docs.hh"
+#include <sstream>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace kyaml;
+
+namespace
+{
+  string describe(event const &e)
+  {
+    switch(e.type)
+    {
+    case event::START_SEQUENCE:
+      return "+SEQ";
+    case event::END_SEQUENCE:
+      return "-SEQ";
+    case event::START_MAPPING:
+      return "+MAP";
+    case event::END_MAPPING:
+      return "-MAP";
+    case event::SCALAR:
+      return "=VAL " + e.value;
+    case event::ALIAS:
+      return "=ALI " + e.value;
+    case event::ANCHOR:
+      return "&" + e.value;
+    case event::TAG:
+      return "TAG " + e.value;
+    }
+    return "?";
+  }
+
+  string describe_at(event_handler::position const &pos, string const &what)
+  {
+    return what + " @" + to_string(pos.line) + ":" + to_string(pos.column);
+  }
+
+  // the push interface, for comparison
+  class recording_handler : public event_handler
+  {
+  public:
+    vector<string> events;
+
+    void start_sequence(position const &pos) override
+    {
+      add(pos, event::START_SEQUENCE);
+    }
+
+    void end_sequence(position const &pos) override
+    {
+      add(pos, event::END_SEQUENCE);
+    }
+
+    void start_mapping(position const &pos) override
+    {
+      add(pos, event::START_MAPPING);
+    }
+
+    void end_mapping(position const &pos) override
+    {
+      add(pos, event::END_MAPPING);
+    }
+
+    void scalar(position const &pos, string const &value) override
+    {
+      add(pos, event::SCALAR, value);
+    }
+
+    void alias(position const &pos, string const &name) override
+    {
+      add(pos, event::ALIAS, name);
+    }
+
+    void anchor(position const &pos, string const &name) override
+    {
+      add(pos, event::ANCHOR, name);
+    }
+
+    void tag(position const &pos, string const &tag) override
+    {
+      add(pos, event::TAG, tag);
+    }
+
+  private:
+    void add(position const &pos, event::type_t type, string const &value = string())
+    {
+      events.push_back(describe_at(pos, describe(event{type, value, pos})));
+    }
+  };
+
+  // all documents, with their events or the line of their error
+  vector<vector<string> > pull_all(string const &input)
+  {
+    stringstream stream(input);
+    parser p(stream);
+
+    vector<vector<string> > result;
+    while(stream.good())
+    {
+      result.emplace_back();
+      try
+      {
+        event_reader reader(p);
+        event e;
+        while(reader.next(e))
+          result.back().push_back(describe_at(e.pos, describe(e)));
+      }
+      catch(parser::error const &e)
+      {
+        result.back().push_back("error at " + to_string(e.linenumber()));
+      }
+    }
+    return result;
+  }
+
+  vector<vector<string> > push_all(string const &input)
+  {
+    stringstream stream(input);
+    parser p(stream);
+
+    vector<vector<string> > result;
+    while(stream.good())
+    {
+      recording_handler handler;
+      try
+      {
+        p.parse(handler);
+      }
+      catch(parser::error const &e)
+      {
+        handler.events.push_back("error at " + to_string(e.linenumber()));
+      }
+      result.push_back(handler.events);
+    }
+    return result;
+  }
+
+  vector<string> read_all(parser &p)
+  {
+    vector<string> result;
+
+    event_reader reader(p);
+    event e;
+    while(reader.next(e))
+      result.push_back(describe(e));
+
+    return result;
+  }
+}
+
+TEST(event_reader, document)
+{
+  stringstream stream("key:\n"
+                      "  - a\n"
+                      "  - &anchor b\n"
+                      "other: *anchor\n"
+                      "tagged: !!str 1\n");
+  parser p(stream);
+
+  vector<string> expect = {
+    "+MAP",
+    "=VAL key",
+    "+SEQ",
+    "=VAL a",
+    "&anchor",
+    "=VAL b",
+    "-SEQ",
+    "=VAL other",
+    "=ALI anchor",
+    "=VAL tagged",
+    "TAG !!str",
+    "=VAL 1",
+    "-MAP",
+  };
+
+  EXPECT_EQ(expect, read_all(p));
+}
+
+TEST(event_reader, stop_early)
+{
+  stringstream input;
+  input << "metadata:\n"
+        << "  name: first\n"
+        << "items:\n";
+  for(int i = 0; i < 10000; ++i)
+    input << "  - item " << i << "\n";
+  input << "---\n"
+        << "second: document\n";
+
+  parser p(input);
+
+  {
+    event_reader reader(p);
+    event e;
+    ASSERT_TRUE(reader.next(e));
+    EXPECT_EQ(event::START_MAPPING, e.type);
+    ASSERT_TRUE(reader.next(e));
+    EXPECT_EQ("metadata", e.value);
+    ASSERT_TRUE(reader.next(e));
+    ASSERT_TRUE(reader.next(e));
+    ASSERT_TRUE(reader.next(e));
+    EXPECT_EQ("first", e.value);
+    EXPECT_EQ(2u, e.pos.line);
+  }
+
+  // the rest of the first document is skipped
+  vector<string> expect = {
+    "+MAP",
+    "=VAL second",
+    "=VAL document",
+    "-MAP",
+  };
+  EXPECT_EQ(expect, read_all(p));
+}
+
+TEST(event_reader, many_events)
+{
+  stringstream input;
+  for(int i = 0; i < 1000; ++i)
+    input << "- " << i << "\n";
+  parser p(input);
+
+  vector<string> events = read_all(p);
+  ASSERT_EQ(1002u, events.size());
+  EXPECT_EQ("=VAL 0", events[1]);
+  EXPECT_EQ("=VAL 999", events[1000]);
+  EXPECT_EQ("-SEQ", events[1001]);
+}
+
+TEST(event_reader, error)
+{
+  stringstream stream("[ a\n");
+  parser p(stream);
+
+  event_reader reader(p);
+  event e;
+  EXPECT_THROW(while(reader.next(e)) {}, parser::parse_error);
+}
+
+TEST(event_reader, reads_as_far_as_needed)
+{
+  stringstream input;
+  input << "first: entry\n"
+        << "items:\n";
+  for(int i = 0; i < 10000; ++i)
+    input << "  - item " << i << "\n";
+  parser p(input);
+
+  event_reader reader(p);
+  event e;
+  ASSERT_TRUE(reader.next(e));
+  EXPECT_EQ(event::START_MAPPING, e.type);
+  ASSERT_TRUE(reader.next(e));
+  ASSERT_TRUE(reader.next(e));
+  EXPECT_EQ("entry", e.value);
+
+  // the next entry was not looked at yet
+  EXPECT_EQ(2u, p.linenumber());
+}
+
+TEST(event_reader, error_after_entries)
+{
+  stringstream stream("- a\n"
+                      "- b\n"
+                      " - c\n");
+  parser p(stream);
+
+  event_reader reader(p);
+  event e;
+  ASSERT_TRUE(reader.next(e));
+  EXPECT_EQ(event::START_SEQUENCE, e.type);
+  ASSERT_TRUE(reader.next(e));
+  EXPECT_EQ("a", e.value);
+  ASSERT_TRUE(reader.next(e));
+  EXPECT_EQ("b", e.value);
+  ASSERT_TRUE(reader.next(e));
+  EXPECT_EQ(event::END_SEQUENCE, e.type);
+  EXPECT_THROW(reader.next(e), parser::parse_error);
+}
+
+class event_reader_samples : public testing::TestWithParam<string const *>
+{};
+
+TEST_P(event_reader_samples, same_as_push)
+{
+  EXPECT_EQ(push_all(*GetParam()), pull_all(*GetParam()));
+}
+
+INSTANTIATE_TEST_SUITE_P(samples,
+                         event_reader_samples,
+                         testing::Values(&kyaml::test::g_oz_yaml,
+                                         &kyaml::test::g_anchors_yaml,
+                                         &kyaml::test::g_datatypes_yaml,
+                                         &kyaml::test::g_chomp_yaml,
+                                         &kyaml::test::g_multi_yaml,
+                                         &kyaml::test::g_unhappy_stream_yaml));
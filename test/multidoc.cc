@@ -1,6 +1,9 @@
 #include "kyaml.hh"
 #include "sample_docs.hh"
 #include "utils.hh"
+#include <fstream>
+#include <cstdio>
+#include <system_error>
 #include <gtest/gtest.h>
 
 using namespace std;
@@ -205,3 +208,87 @@ TEST_F(unhappy, invalid_anchor)
   check_sync("---\n# eos 6", 30);
 }
 
+
+TEST(multidoc_buffer, all)
+{
+  // same stream as above, parsed directly from memory
+  string_view input(g_multi_yaml);
+  kyaml::parser p(input);
+
+  unique_ptr<const document> root = p.parse();
+  ASSERT_TRUE((bool)root);
+  EXPECT_EQ("bare document", root->leaf_value());
+
+  root = p.parse();
+  ASSERT_TRUE((bool)root);
+  EXPECT_EQ("item 2", root->leaf_value("sequence", 1));
+
+  root = p.parse();
+  ASSERT_TRUE((bool)root);
+  EXPECT_EQ("value 2", root->leaf_value("mapping", "key2"));
+}
+
+TEST(multidoc_file, all)
+{
+  const string filename = testing::TempDir() + "kyaml_multidoc_file.yaml";
+  {
+    ofstream out(filename);
+    out << g_multi_yaml;
+  }
+
+  kyaml::parser p = kyaml::parser::from_file(filename);
+
+  unique_ptr<const document> root = p.parse();
+  ASSERT_TRUE((bool)root);
+  EXPECT_EQ("bare document", root->leaf_value());
+
+  root = p.parse();
+  ASSERT_TRUE((bool)root);
+  EXPECT_EQ("item 1", root->leaf_value("sequence", 0));
+
+  root = p.parse();
+  ASSERT_TRUE((bool)root);
+  EXPECT_EQ("value 1", root->leaf_value("mapping", "key1"));
+
+  remove(filename.c_str());
+}
+
+TEST(multidoc_file, missing)
+{
+  EXPECT_THROW(kyaml::parser::from_file(testing::TempDir() + "kyaml_does_not_exist.yaml"), system_error);
+}
+
+namespace
+{
+  // parse all documents in the stream, writing either the document or the error line to the transcript
+  string transcript(string const &input, parser::options const &opts)
+  {
+    stringstream result;
+    kyaml::parser p(string_view(input.data(), input.size()), opts);
+
+    for(unsigned i = 0; i < 10; ++i)
+    {
+      try
+      {
+        unique_ptr<const document> root = p.parse();
+        if(root)
+          result << *root << '\n';
+      }
+      catch(parser::error const &e)
+      {
+        result << "error at " << e.linenumber() << '\n';
+      }
+    }
+
+    return result.str();
+  }
+}
+
+TEST(multidoc_memoize, same_result)
+{
+  parser::options memoized;
+  memoized.memoize = true;
+
+  for(string const &input : { g_oz_yaml, g_anchors_yaml, g_datatypes_yaml, g_chomp_yaml, g_multi_yaml, g_unhappy_stream_yaml })
+    EXPECT_EQ(transcript(input, parser::options()), transcript(input, memoized));
+}
@@ -1,5 +1,6 @@
 #include "kyaml.hh"
 #include "sample_docs.hh"
+#include "node_arena.hh"
 #include <cassert>
 #include <gtest/gtest.h>
 
@@ -143,3 +144,479 @@ TEST_F(node_typeconvert_test, string_as_bool)
 {
   check(false, "simple_string");
 }
+
+TEST(node_arena, blocks)
+{
+  node_arena arena;
+
+  vector<scalar *> scalars;
+  for(int i = 0; i < 10000; ++i)
+    scalars.push_back(arena.create<scalar>(to_string(i) + string(30, 'x')));
+
+  EXPECT_EQ(10000u, arena.size());
+  for(int i = 0; i < 10000; ++i)
+  {
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(scalars[i]) % alignof(scalar));
+    EXPECT_EQ(to_string(i) + string(30, 'x'), scalars[i]->get());
+  }
+}
+
+TEST(node_arena, shared_and_owned)
+{
+  node_arena arena;
+
+  mapping m;
+  m.add("shared", make_shared<scalar>("a"));
+  m.add("owned", arena.create<scalar>("b"));
+
+  sequence s;
+  s.add(make_shared<scalar>("c"));
+  s.add(arena.create<scalar>("d"));
+
+  EXPECT_EQ("a", m.leaf_value("shared"));
+  EXPECT_EQ("b", m.leaf_value("owned"));
+  EXPECT_EQ("c", s.leaf_value(0));
+  EXPECT_EQ("d", s.leaf_value(1));
+}
+
+TEST(node_arena, aliases)
+{
+  stringstream stream("a: &x\n"
+                      "  - 1\n"
+                      "b: *x\n");
+  parser p(stream);
+  unique_ptr<const document> doc = p.parse();
+
+  EXPECT_EQ(&doc->value("a"), &doc->value("b"));
+  EXPECT_EQ("1", doc->leaf_value("b", 0));
+}
+
+TEST(node_arena, copy_collections)
+{
+  stringstream stream("m: !tagged\n"
+                      "  a: 1\n"
+                      "s: [x, y]\n");
+  parser p(stream);
+  unique_ptr<const document> doc = p.parse();
+
+  mapping m = doc->value("m").as_mapping();
+  sequence s = doc->value("s").as_sequence();
+  mapping root = doc->as_mapping();
+
+  EXPECT_EQ("1", m.leaf_value("a"));
+  EXPECT_TRUE(m.has_property("!tagged"));
+  EXPECT_EQ("y", s.leaf_value(1));
+  EXPECT_EQ(&doc->value("s"), &root.value("s"));
+
+  mapping moved = std::move(m);
+  EXPECT_EQ("1", moved.leaf_value("a"));
+}
+
+TEST(node_arena, copy_outlives_document)
+{
+  auto input = make_shared<string const>("m: !tagged\n"
+                                         "  a: some text\n"
+                                         "  s: [x, y]\n");
+  weak_ptr<string const> weak = input;
+  unique_ptr<mapping> m;
+  {
+    parser p(input);
+    unique_ptr<const document> doc = p.parse();
+    m = make_unique<mapping>(doc->value("m").as_mapping());
+  }
+  input.reset();
+
+  EXPECT_FALSE(weak.expired());
+  EXPECT_EQ("some text", m->leaf_value("a"));
+  EXPECT_EQ("y", m->leaf_value("s", 1));
+  EXPECT_TRUE(m->has_property("!tagged"));
+
+  mapping copy = *m;
+  m.reset();
+  EXPECT_EQ("x", copy.leaf_value("s", 0));
+  EXPECT_FALSE(weak.expired());
+}
+
+namespace
+{
+  bool points_into(string const &buffer, string_view v)
+  {
+    return v.data() >= buffer.data() && v.data() + v.size() <= buffer.data() + buffer.size();
+  }
+
+  scalar const &as_scalar(node const &n)
+  {
+    assert(n.type() == node::SCALAR);
+    return static_cast<scalar const &>(n);
+  }
+}
+
+TEST(borrowed_scalar, refers_to_input)
+{
+  auto input = make_shared<string const>("plain: some value\n"
+                                         "single: 'quoted text'\n"
+                                         "escaped: \"a\\tb\"\n"
+                                         "doubled: 'it''s'\n"
+                                         "folded: >\n"
+                                         "  one\n"
+                                         "  two\n");
+  parser p(input);
+  unique_ptr<const document> doc = p.parse();
+
+  scalar const &plain = as_scalar(doc->value("plain"));
+  EXPECT_TRUE(plain.borrowed());
+  EXPECT_TRUE(points_into(*input, plain.view()));
+  EXPECT_EQ("some value", plain.view());
+  EXPECT_EQ("some value", plain.get());
+
+  scalar const &single = as_scalar(doc->value("single"));
+  EXPECT_TRUE(single.borrowed());
+  EXPECT_TRUE(points_into(*input, single.view()));
+  EXPECT_EQ("quoted text", single.view());
+
+  EXPECT_FALSE(as_scalar(doc->value("escaped")).borrowed());
+  EXPECT_EQ("a\tb", doc->leaf_value("escaped"));
+  EXPECT_FALSE(as_scalar(doc->value("doubled")).borrowed());
+  EXPECT_EQ("it's", doc->leaf_value("doubled"));
+  EXPECT_FALSE(as_scalar(doc->value("folded")).borrowed());
+  EXPECT_EQ("one two\n", doc->leaf_value("folded"));
+}
+
+TEST(borrowed_scalar, keeps_input_alive)
+{
+  auto input = make_shared<string const>("key: value\n");
+  weak_ptr<string const> weak = input;
+
+  unique_ptr<const document> doc;
+  {
+    parser p(input);
+    doc = p.parse();
+  }
+  input.reset();
+
+  EXPECT_FALSE(weak.expired());
+  EXPECT_EQ("value", as_scalar(doc->value("key")).view());
+
+  doc.reset();
+  EXPECT_TRUE(weak.expired());
+}
+
+TEST(borrowed_scalar, copies_without_keep_alive)
+{
+  string input = "key: value\n";
+  parser p(input);
+  unique_ptr<const document> doc = p.parse();
+
+  scalar const &s = as_scalar(doc->value("key"));
+  EXPECT_FALSE(s.borrowed());
+  EXPECT_FALSE(points_into(input, s.view()));
+  EXPECT_EQ("value", s.view());
+}
+
+TEST(borrowed_scalar, copy_owns_value)
+{
+  auto input = make_shared<string const>("key: value\n"
+                                         "n: 12\n");
+  unique_ptr<const document> doc;
+  {
+    parser::options opts;
+    opts.resolve = true;
+    parser p(input, opts);
+    doc = p.parse();
+  }
+
+  scalar copy = as_scalar(doc->value("key"));
+  scalar number = as_scalar(doc->value("n"));
+  doc.reset();
+  input.reset();
+
+  EXPECT_FALSE(copy.borrowed());
+  EXPECT_EQ("value", copy.get());
+  EXPECT_EQ(scalar::INT, number.resolved());
+  EXPECT_EQ(12, number.as<int>());
+
+  scalar moved = std::move(copy);
+  EXPECT_EQ("value", moved.view());
+
+  scalar assigned("other");
+  assigned = moved;
+  EXPECT_EQ("value", assigned.get());
+}
+
+TEST(borrowed_scalar, print_without_copy)
+{
+  auto input = make_shared<string const>("key: value\n");
+  parser p(input);
+  unique_ptr<const document> doc = p.parse();
+
+  stringstream out;
+  out << doc->value("key");
+  EXPECT_EQ("value", out.str());
+}
+
+TEST(borrowed_scalar, convert_from_view)
+{
+  auto input = make_shared<string const>("n: 12\n"
+                                         "flag: yes\n"
+                                         "text: value\n");
+  parser p(input);
+  unique_ptr<const document> doc = p.parse();
+
+  EXPECT_TRUE(points_into(*input, doc->leaf_view("text")));
+  EXPECT_EQ("value", doc->leaf_view("text"));
+  EXPECT_EQ(12, as_scalar(doc->value("n")).as<int>());
+  EXPECT_TRUE(as_scalar(doc->value("flag")).as<bool>());
+  EXPECT_EQ("value", as_scalar(doc->value("text")).as<string>());
+
+  EXPECT_THROW(doc->view(), node::type_error);
+}
+
+TEST(mapping, source_order)
+{
+  stringstream stream("z: 1\n"
+                      "a: 2\n"
+                      "m: {y: 3, b: 4}\n");
+  parser p(stream);
+  unique_ptr<const document> doc = p.parse();
+
+  vector<string> keys;
+  for(auto&& kv : doc->as_mapping())
+    keys.push_back(kv.first);
+  EXPECT_EQ(vector<string>({"z", "a", "m"}), keys);
+
+  stringstream out;
+  out << *doc;
+  EXPECT_EQ("{z: 1, a: 2, m: {y: 3, b: 4}}", out.str());
+}
+
+TEST(mapping, indexed)
+{
+  mapping m;
+  for(int i = 0; i < 1000; ++i)
+    m.add(to_string(i), make_shared<scalar>("v" + to_string(i)));
+
+  EXPECT_EQ(1000u, m.size());
+  for(int i = 0; i < 1000; ++i)
+  {
+    EXPECT_TRUE(m.has(to_string(i)));
+    EXPECT_EQ("v" + to_string(i), m.leaf_value(to_string(i)));
+  }
+  EXPECT_FALSE(m.has("1000"));
+  EXPECT_THROW(m.get("-1"), node::value_error);
+
+  int i = 0;
+  for(auto&& kv : m)
+    EXPECT_EQ(to_string(i++), kv.first);
+}
+
+TEST(mapping, first_key_wins)
+{
+  mapping small;
+  small.add("a", make_shared<scalar>("1"));
+  small.add("a", make_shared<scalar>("2"));
+  EXPECT_EQ(1u, small.size());
+  EXPECT_EQ("1", small.leaf_value("a"));
+
+  mapping large;
+  for(int i = 0; i < 20; ++i)
+    large.add(to_string(i), make_shared<scalar>("first"));
+  for(int i = 0; i < 20; ++i)
+    large.add(to_string(i), make_shared<scalar>("second"));
+  EXPECT_EQ(20u, large.size());
+  EXPECT_EQ("first", large.leaf_value("13"));
+}
+
+TEST(node_find, paths)
+{
+  stringstream stream("a:\n"
+                      "  b: [x, {c: y}]\n"
+                      "d: z\n");
+  parser p(stream);
+  unique_ptr<const document> doc = p.parse();
+
+  EXPECT_EQ(doc.get(), doc->find());
+  EXPECT_EQ(&doc->value("a", "b", 1, "c"), doc->find("a", "b", 1, "c"));
+  EXPECT_EQ("z", doc->find(string("d"))->get());
+  EXPECT_EQ("x", doc->find(string_view("a"), "b", 0)->get());
+
+  EXPECT_EQ(nullptr, doc->find("nope"));
+  EXPECT_EQ(nullptr, doc->find("a", "b", 2));
+  EXPECT_EQ(nullptr, doc->find("a", 0));       // type mismatch
+  EXPECT_EQ(nullptr, doc->find("d", "e"));     // scalars have no children
+  EXPECT_EQ(nullptr, doc->find("a", "b", "c"));
+
+  EXPECT_TRUE(doc->has("a", "b", 1));
+  EXPECT_FALSE(doc->has("a", "b", 1, "d"));
+  EXPECT_TRUE(doc->has_leaf("a", "b", 1, "c"));
+  EXPECT_FALSE(doc->has_leaf("a", "b"));
+  EXPECT_FALSE(doc->has_leaf("a", "x"));
+}
+
+TEST(node_tags, interned)
+{
+  stringstream stream("a: !!int 1\n"
+                      "b: !app 2\n"
+                      "c: 3\n"
+                      "---\n"
+                      "d: !app 4\n");
+  unique_ptr<parser> p(new parser(stream));
+  unique_ptr<const document> first = p->parse();
+  unique_ptr<const document> second = p->parse();
+
+  node const &a = first->value("a");
+  ASSERT_EQ(1u, a.properties().size());
+  EXPECT_EQ(&scalar::int_property, a.properties().at(0));
+  EXPECT_TRUE(a.has_property(&scalar::int_property));
+  EXPECT_TRUE(a.has_property("!!int"));
+  EXPECT_FALSE(a.has_property(&scalar::float_property));
+
+  // the same parser interns the same tag once
+  tag_id app = first->value("b").properties().at(0);
+  EXPECT_EQ("!app", *app);
+  EXPECT_TRUE(second->value("d").has_property(app));
+
+  EXPECT_TRUE(first->value("c").properties().empty());
+
+  // outlives the parser
+  p.reset();
+  EXPECT_TRUE(second->value("d").has_property("!app"));
+}
+
+TEST(node_tags, by_hand)
+{
+  scalar s("x");
+  s.add_property("!custom");
+  s.add_property(scalar::string_property);
+  s.add_property("!custom");
+
+  EXPECT_EQ(2u, s.properties().size());
+  EXPECT_TRUE(s.has_property("!custom"));
+  EXPECT_TRUE(s.has_property(&scalar::string_property));
+  EXPECT_EQ(1u, s.properties().count("!!str"));
+
+  vector<string> tags(s.properties().begin(), s.properties().end());
+  EXPECT_EQ(vector<string>({"!custom", "!!str"}), tags);
+}
+
+TEST(scalar_resolve, core_schema)
+{
+  stringstream stream("n: ~\n"
+                      "b: true\n"
+                      "i: 0x10\n"
+                      "f: -1.5e2\n"
+                      "s: hello\n"
+                      "q: \"12\"\n"
+                      "tagged_str: !!str 12\n"
+                      "tagged_int: !!int \"7\"\n"
+                      "custom: !app 12\n");
+  parser::options opts;
+  opts.resolve = true;
+  parser p(stream, opts);
+  unique_ptr<const document> doc = p.parse();
+
+  auto resolved = [&](char const *key) { return doc->value(key).as_scalar().resolved(); };
+
+  EXPECT_EQ(scalar::NULL_VALUE, resolved("n"));
+  EXPECT_EQ(scalar::BOOL, resolved("b"));
+  EXPECT_EQ(scalar::INT, resolved("i"));
+  EXPECT_EQ(scalar::FLOAT, resolved("f"));
+  EXPECT_EQ(scalar::STRING, resolved("s"));
+  EXPECT_EQ(scalar::STRING, resolved("q"));
+  EXPECT_EQ(scalar::STRING, resolved("tagged_str"));
+  EXPECT_EQ(scalar::INT, resolved("tagged_int"));
+  EXPECT_EQ(scalar::UNRESOLVED, resolved("custom"));
+
+  EXPECT_TRUE(doc->value("b").as_scalar().as<bool>());
+  EXPECT_EQ(16, doc->value("i").as_scalar().as<int>());
+  EXPECT_EQ(16u, doc->value("i").as_scalar().as<uint64_t>());
+  EXPECT_DOUBLE_EQ(16.0, doc->value("i").as_scalar().as<double>());
+  EXPECT_DOUBLE_EQ(-150.0, doc->value("f").as_scalar().as<double>());
+  EXPECT_EQ(7, doc->value("tagged_int").as_scalar().as<long>());
+  EXPECT_EQ(12, doc->value("custom").as_scalar().as<int>());
+  EXPECT_EQ("hello", doc->value("s").as_scalar().as<string>());
+}
+
+TEST(scalar_resolve, off_by_default)
+{
+  stringstream stream("i: 12\n");
+  parser p(stream);
+  unique_ptr<const document> doc = p.parse();
+
+  EXPECT_EQ(scalar::UNRESOLVED, doc->value("i").as_scalar().resolved());
+  EXPECT_EQ(12, doc->value("i").as_scalar().as<int>());
+}
+
+TEST(scalar_resolve, narrow_targets)
+{
+  scalar s("300");
+  s.resolve(true);
+  EXPECT_EQ(scalar::INT, s.resolved());
+  EXPECT_EQ(300, s.as<short>());
+  EXPECT_EQ(300u, s.as<unsigned>());
+
+  scalar n("-1");
+  n.resolve(true);
+  EXPECT_EQ(-1, n.as<int>());
+}
+
+TEST(number_convert, integers)
+{
+  node::properties_t none;
+
+  EXPECT_EQ(42, type_convert<int>(none, "42"));
+  EXPECT_EQ(-42, type_convert<int>(none, " -42 "));
+  EXPECT_EQ(31, type_convert<int>(none, "0x1F"));
+  EXPECT_EQ(-8, type_convert<long>(none, "-0o10"));
+  EXPECT_EQ(5, type_convert<short>(none, "0b101"));
+  EXPECT_EQ(1000000, type_convert<int>(none, "1_000_000"));
+  EXPECT_EQ(numeric_limits<int64_t>::min(), type_convert<int64_t>(none, "-9223372036854775808"));
+  EXPECT_EQ(numeric_limits<uint64_t>::max(), type_convert<uint64_t>(none, "18446744073709551615"));
+  EXPECT_EQ(3, type_convert<int>(none, "3.99"));
+  EXPECT_EQ(1000, type_convert<int>(none, "1e3"));
+
+  EXPECT_EQ(0, type_convert<int>(none, "abc"));
+  EXPECT_EQ(0, type_convert<int>(none, "12abc"));
+  EXPECT_EQ(0, type_convert<int>(none, "_1"));
+  EXPECT_EQ(0, type_convert<int>(none, ".nan"));
+}
+
+TEST(number_convert, integer_overflow)
+{
+  node::properties_t none;
+
+  EXPECT_THROW(type_convert<int>(none, "2147483648"), node::value_error);
+  EXPECT_THROW(type_convert<short>(none, "-40000"), node::value_error);
+  EXPECT_THROW(type_convert<unsigned>(none, "-1"), node::value_error);
+  EXPECT_THROW(type_convert<int64_t>(none, "9223372036854775808"), node::value_error);
+  EXPECT_THROW(type_convert<uint64_t>(none, "0x1_0000_0000_0000_0000"), node::value_error);
+  EXPECT_THROW(type_convert<int>(none, "1e10"), node::value_error);
+  EXPECT_THROW(type_convert<int>(none, ".inf"), node::value_error);
+}
+
+TEST(number_convert, floats)
+{
+  node::properties_t none;
+
+  EXPECT_DOUBLE_EQ(3.25, type_convert<double>(none, "3.25"));
+  EXPECT_DOUBLE_EQ(-0.5, type_convert<double>(none, "-.5"));
+  EXPECT_DOUBLE_EQ(1200.5, type_convert<double>(none, "+1_200.5"));
+  EXPECT_DOUBLE_EQ(255.0, type_convert<double>(none, "0xff"));
+  EXPECT_FLOAT_EQ(6.5e-3f, type_convert<float>(none, "6.5E-3"));
+  EXPECT_TRUE(isinf(type_convert<double>(none, "-.Inf")));
+  EXPECT_TRUE(isnan(type_convert<float>(none, ".NAN")));
+  EXPECT_DOUBLE_EQ(0.0, type_convert<double>(none, "1e-400"));
+  EXPECT_DOUBLE_EQ(0.0, type_convert<double>(none, "pi"));
+
+  EXPECT_THROW(type_convert<double>(none, "1e400"), node::value_error);
+  EXPECT_THROW(type_convert<float>(none, "1e39"), node::value_error);
+}
+
+TEST(number_convert, bools)
+{
+  node::properties_t none;
+
+  EXPECT_TRUE(type_convert<bool>(none, "2"));
+  EXPECT_FALSE(type_convert<bool>(none, "0.5"));
+  EXPECT_TRUE(type_convert<bool>(none, "99999999999999999999"));
+  EXPECT_FALSE(type_convert<bool>(none, "maybe"));
+}
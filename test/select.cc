@@ -0,0 +1,122 @@
+#include "kyaml.hh"
+#include <sstream>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace kyaml;
+
+namespace
+{
+  const string manifest =
+    "apiVersion: v1\n"
+    "kind: Pod\n"
+    "metadata:\n"
+    "  name: web\n"
+    "  labels:\n"
+    "    app: &app frontend\n"
+    "    tier: *app\n"
+    "spec:\n"
+    "  replicas: 3\n"
+    "  containers:\n"
+    "    - name: nginx\n"
+    "      image: nginx-1.25\n"
+    "      ports: [80, 443]\n"
+    "    - name: sidecar\n"
+    "      image: !!str envoy\n"
+    "    - {name: init, image: busybox}\n";
+
+  unique_ptr<const document> parse_select(string const &input, vector<string> const &select)
+  {
+    stringstream stream(input);
+
+    parser::options opts;
+    opts.select = select;
+    parser p(stream, opts);
+    return p.parse();
+  }
+}
+
+TEST(select, fields)
+{
+  auto doc = parse_select(manifest, {"metadata.name", "spec.containers[*].image"});
+  ASSERT_TRUE((bool)doc);
+
+  EXPECT_EQ("web", doc->leaf_value("metadata", "name"));
+  EXPECT_EQ("nginx-1.25", doc->leaf_value("spec", "containers", 0, "image"));
+  EXPECT_EQ("envoy", doc->leaf_value("spec", "containers", 1, "image"));
+  EXPECT_EQ("busybox", doc->leaf_value("spec", "containers", 2, "image"));
+  EXPECT_TRUE(doc->value("spec", "containers", 1, "image").has_property("!!str"));
+
+  EXPECT_FALSE(doc->has("apiVersion"));
+  EXPECT_FALSE(doc->has("metadata", "labels"));
+  EXPECT_FALSE(doc->has("spec", "replicas"));
+  EXPECT_FALSE(doc->has("spec", "containers", 0, "name"));
+  EXPECT_FALSE(doc->has("spec", "containers", 0, "ports"));
+}
+
+TEST(select, subtree)
+{
+  auto doc = parse_select(manifest, {"metadata.labels"});
+  ASSERT_TRUE((bool)doc);
+
+  EXPECT_EQ("frontend", doc->leaf_value("metadata", "labels", "app"));
+  EXPECT_EQ("frontend", doc->leaf_value("metadata", "labels", "tier"));
+  EXPECT_FALSE(doc->has("metadata", "name"));
+  EXPECT_FALSE(doc->has("spec"));
+}
+
+TEST(select, indices)
+{
+  auto doc = parse_select(manifest, {"spec.containers[1].name", "*.replicas"});
+  ASSERT_TRUE((bool)doc);
+
+  EXPECT_EQ("3", doc->leaf_value("spec", "replicas"));
+  EXPECT_EQ("sidecar", doc->leaf_value("spec", "containers", 1, "name"));
+  EXPECT_EQ(2u, doc->value("spec", "containers").as_sequence().size());
+  EXPECT_FALSE(doc->has("spec", "containers", 0, "name"));
+
+  // the entry before the selected one is a placeholder
+  EXPECT_TRUE(doc->value("spec", "containers", 0).has_property(&scalar::skipped_property));
+  EXPECT_TRUE(doc->value("spec", "containers", 0).has_property("!kyaml/skipped"));
+  EXPECT_EQ("", doc->leaf_value("spec", "containers", 0));
+  EXPECT_FALSE(doc->value("spec", "containers", 1).has_property(&scalar::skipped_property));
+}
+
+TEST(select, placeholders_on_tape)
+{
+  stringstream stream(manifest);
+  parser::options opts;
+  opts.select = {"spec.containers[2].name"};
+  parser p(stream, opts);
+  tape t = p.parse_tape();
+
+  tape::item containers = t.root().value("spec", "containers");
+  ASSERT_EQ(3u, containers.size());
+  EXPECT_TRUE(containers.get(0).has_property(scalar::skipped_property));
+  EXPECT_TRUE(containers.get(1).has_property(scalar::skipped_property));
+  EXPECT_EQ("init", containers.leaf_value(2, "name"));
+}
+
+TEST(select, too_deep)
+{
+  auto doc = parse_select(manifest, {"kind.name", "spec.containers[0].ports[1]"});
+  ASSERT_TRUE((bool)doc);
+
+  EXPECT_FALSE(doc->has("kind"));
+  EXPECT_EQ("443", doc->leaf_value("spec", "containers", 0, "ports", 1));
+}
+
+TEST(select, malformed)
+{
+  for(char const *pattern : {"a..b", "a.", "a[x]", "a[1", ""})
+  {
+    stringstream stream(manifest);
+    parser::options opts;
+    opts.select = {pattern};
+    if(!*pattern)
+      EXPECT_NO_THROW(parser(stream, opts)) << pattern;
+    else
+      EXPECT_THROW(parser(stream, opts), invalid_argument) << pattern;
+  }
+}
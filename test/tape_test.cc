@@ -0,0 +1,85 @@
+#include "kyaml.hh"
+#include <sstream>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace kyaml;
+
+namespace
+{
+  tape parse_tape(string const &input)
+  {
+    stringstream stream(input);
+    parser p(stream);
+    return p.parse_tape();
+  }
+}
+
+TEST(tape, lookup)
+{
+  tape t = parse_tape("name: web\n"
+                      "containers:\n"
+                      "  - image: nginx\n"
+                      "    ports: [80, 443]\n"
+                      "  - image: !!str envoy\n"
+                      "replicas: 3\n");
+
+  tape::item root = t.root();
+  EXPECT_EQ(node::MAPPING, root.type());
+  EXPECT_EQ(3u, root.size());
+
+  EXPECT_EQ("web", root.leaf_value("name"));
+  EXPECT_EQ("3", root.leaf_value("replicas"));
+  EXPECT_EQ(2u, root.value("containers").size());
+  EXPECT_EQ("nginx", root.leaf_value("containers", 0, "image"));
+  EXPECT_EQ("443", root.leaf_value("containers", 0, "ports", 1));
+  EXPECT_EQ("envoy", root.leaf_value("containers", 1, "image"));
+  EXPECT_TRUE(root.value("containers", 1, "image").has_property("!!str"));
+
+  EXPECT_TRUE(root.has("containers", 1, "image"));
+  EXPECT_FALSE(root.has("containers", 2));
+  EXPECT_FALSE(root.has("name", 0));
+  EXPECT_THROW(root.get("missing"), node::value_error);
+  EXPECT_THROW(root.get(0), node::type_error);
+}
+
+TEST(tape, skip)
+{
+  tape t = parse_tape("[[a, [b, c]], d]");
+
+  // the start of a collection points past its end
+  vector<uint64_t> const &e = t.entries();
+  ASSERT_EQ(tape::START_SEQUENCE, tape::type(e[0]));
+  EXPECT_EQ(e.size(), tape::payload(e[0]));
+  ASSERT_EQ(tape::START_SEQUENCE, tape::type(e[1]));
+  EXPECT_EQ(tape::SCALAR, tape::type(e[tape::payload(e[1])]));
+  EXPECT_EQ(tape::END_SEQUENCE, tape::type(e[tape::payload(e[1]) - 1]));
+
+  vector<string> items;
+  for(tape::item it : t.root())
+    items.push_back(it.type() == node::SCALAR ? string(it.get()) : "seq");
+  EXPECT_EQ(vector<string>({"seq", "d"}), items);
+}
+
+TEST(tape, aliases)
+{
+  tape t = parse_tape("a: &x [1, 2]\n"
+                      "b: *x\n");
+
+  EXPECT_EQ(node::SEQUENCE, t.root().value("b").type());
+  EXPECT_EQ("2", t.root().leaf_value("b", 1));
+  EXPECT_EQ(t.root().value("a").index(), t.root().value("b").index());
+
+  stringstream stream("a: *y\n");
+  parser p(stream);
+  EXPECT_THROW(p.parse_tape(), parser::content_error);
+}
+
+TEST(tape, copy)
+{
+  tape t = parse_tape("a: b\n");
+  tape copy = t;
+  t = tape();
+
+  EXPECT_EQ("b", copy.root().leaf_value("a"));
+}
@@ -206,6 +206,36 @@ TEST_F(toplevel, indent_in_string_literal_as_space)
   check(expect);
 }
 
+TEST_F(toplevel, trailing_comments_after_literal)
+{
+  const string input = "a: |\n"
+                       "  x\n"
+                       "\n"
+                       "# c1 one\n"
+                       "# c2 two\n"
+                       "b: 1\n";
+
+  parse(input);
+
+  check("x\n", "a");
+  check("1", "b");
+}
+
+TEST_F(toplevel, trailing_comments_after_folded)
+{
+  const string input = "a: >-\n"
+                       "  x\n"
+                       "  y\n"
+                       " # indented less\n"
+                       "# c\n"
+                       "b: 1\n";
+
+  parse(input);
+
+  check("x y", "a");
+  check("1", "b");
+}
+
 TEST_F(toplevel, with_directive)
 {
   const string input = "%YAML 1.2\n"
@@ -331,6 +361,34 @@ TEST_F(toplevel, unterminated_literal)
   check("|"); // the pipe symbol is a valid scalar
 }
 
+TEST_F(toplevel, large_flow_sequence)
+{
+  const size_t n = 100000;
+
+  string input = "[";
+  for(size_t i = 0; i < n; ++i)
+    input += to_string(i) + ", ";
+  input += "]";
+
+  parse(input);
+  check("0", 0);
+  check("99999", n - 1);
+}
+
+TEST_F(toplevel, large_flow_mapping)
+{
+  const size_t n = 100000;
+
+  string input = "{";
+  for(size_t i = 0; i < n; ++i)
+    input += "k" + to_string(i) + ": " + to_string(i) + ", ";
+  input += "}";
+
+  parse(input);
+  check("0", "k0");
+  check("99999", "k99999");
+}
+
 class datatypes : public toplevel
 {
 public:
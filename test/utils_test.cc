@@ -34,6 +34,19 @@ INSTANTIATE_TEST_SUITE_P(utf8_tests,
                         utf8_test,
                         testing::ValuesIn(utf8_testcases));
 
+TEST(utf8, valid_char)
+{
+  EXPECT_TRUE(is_valid_utf8(char32_t('a')));
+  EXPECT_TRUE(is_valid_utf8(char32_t(0xd582)));
+  EXPECT_TRUE(is_valid_utf8(char32_t(0xe282ac)));
+  EXPECT_TRUE(is_valid_utf8(char32_t(0xf09d848b)));
+
+  EXPECT_FALSE(is_valid_utf8(char32_t(0xd5)));     // truncated
+  EXPECT_FALSE(is_valid_utf8(char32_t(0xe282)));   // truncated
+  EXPECT_FALSE(is_valid_utf8(char32_t(0xd541)));   // no continuation byte
+  EXPECT_FALSE(is_valid_utf8(char32_t(0xf09d418b)));
+}
+
 TEST(logger, one_item)
 {
   stringstream str;
@@ -0,0 +1,59 @@
+#include "kyaml.hh"
+#include "sample_docs.hh"
+#include <sstream>
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace kyaml;
+using namespace kyaml::test;
+
+TEST(validate, valid)
+{
+  parser p(g_datatypes_yaml);
+  parser::validation v = p.validate();
+
+  EXPECT_TRUE(v);
+  EXPECT_TRUE(v.message.empty());
+}
+
+TEST(validate, first_error)
+{
+  stringstream stream(g_unhappy_stream_yaml);
+  parser p(stream);
+
+  parser::validation v = p.validate();
+  EXPECT_FALSE(v);
+  EXPECT_EQ(3u, v.linenumber);
+  EXPECT_NE(string::npos, v.message.find("line 3"));
+
+  // synced to the next document, as after a failed parse()
+  EXPECT_EQ("---\n# eos 1", p.peek(11));
+  EXPECT_TRUE(p.validate());
+}
+
+TEST(validate, all)
+{
+  stringstream good(g_multi_yaml);
+  parser pg(good);
+  EXPECT_TRUE(pg.validate_all());
+  EXPECT_TRUE(good.eof());
+
+  stringstream bad(g_unhappy_stream_yaml);
+  parser pb(bad);
+  pb.validate();                      // skip the first error
+  parser::validation v = pb.validate_all();
+  EXPECT_FALSE(v);
+  EXPECT_EQ(17u, v.linenumber);
+}
+
+TEST(validate, aliases_unchecked)
+{
+  parser p(string_view("status: *good\n"));
+  EXPECT_TRUE(p.validate());
+}
+
+TEST(validate, empty)
+{
+  parser p(string_view(""));
+  EXPECT_TRUE(p.validate_all());
+}